@@ -0,0 +1,33 @@
+/*********************************************************************
+ *
+ *                  IGMP Module Defs for Microchip TCP/IP Stack
+ *
+ *********************************************************************
+ * FileName:        IGMP.h
+ * Dependencies:    StackTsk.h
+ *                  IP.h
+ *                  MAC.h
+ * Processor:       PIC32
+ * Compiler:        Microchip C32 v1.05 or higher
+ ********************************************************************/
+#ifndef __IGMP_H
+#define __IGMP_H
+
+// Maximum number of multicast groups that may be joined at the same
+// time, not including the all-hosts group 224.0.0.1 which is always
+// joined.  Override in TCPIPConfig.h if required.
+#if !defined(IGMP_MAX_GROUPS)
+	#define IGMP_MAX_GROUPS		(2u)
+#endif
+
+// Returns TRUE if the IP address is a multicast (class D) address
+#define IGMPIsMulticastAddr(a)	(((a).v[0] & 0xF0u) == 0xE0u)
+
+void IGMPInit(void);
+void IGMPTask(void);
+void IGMPProcess(WORD len);
+BOOL IGMPJoinGroup(IP_ADDR GroupAddr);
+void IGMPLeaveGroup(IP_ADDR GroupAddr);
+void IGMPGetGroupMACAddr(IP_ADDR GroupAddr, MAC_ADDR *MACAddr);
+
+#endif
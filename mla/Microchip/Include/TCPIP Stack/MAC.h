@@ -318,6 +318,14 @@ void MACFlush(void);
 	PTR_BASE MACGetTxBaseAddr(void);
 	PTR_BASE MACGetHttpBaseAddr(void);
 	PTR_BASE MACGetSslBaseAddr(void);
+	BOOL MACIsTxComplete(void);
+	void MACSetRxTimestampFunction(QWORD (*timestampFunction)(void));
+	QWORD MACGetRxTimestamp(void);
+	void MACSetTxTimestampFunction(QWORD (*timestampFunction)(void));
+	QWORD MACGetDeferredTxTimestamp(void);
+	BOOL MACDeferNextFlush(void);
+	BYTE* MACGetDeferredTxBuffer(WORD* len);
+	BOOL MACTransmitDeferred(void);
 #endif
 
 	
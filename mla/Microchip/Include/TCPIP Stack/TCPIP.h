@@ -374,6 +374,10 @@
 	#include "TCPIP Stack/ICMP.h"
 #endif
 
+#if defined(STACK_USE_IGMP)
+	#include "TCPIP Stack/IGMP.h"
+#endif
+
 #if defined(STACK_USE_ANNOUNCE)
 	#include "TCPIP Stack/Announce.h"
 #endif
@@ -156,6 +156,10 @@ WORD UDPIsPutReady(UDP_SOCKET s);
 BOOL UDPPut(BYTE v);
 WORD UDPPutArray(BYTE *cData, WORD wDataLen);
 BYTE* UDPPutString(BYTE *strData);
+#if defined(__PIC32MX__) && defined(_ETH) && !defined(ENC100_INTERFACE_MODE) && !defined(ENC_CS_TRIS) && !defined(WF_CS_TRIS)
+	BYTE* UDPGetTxPointer(WORD *wAvailable);
+	WORD UDPPutDirect(WORD wDataLen);
+#endif
 void UDPFlush(void);
 
 // ROM function variants for PIC18
@@ -171,6 +175,9 @@ WORD UDPIsGetReady(UDP_SOCKET s);
 BOOL UDPGet(BYTE *v);
 WORD UDPGetArray(BYTE *cData, WORD wDataLen);
 void UDPDiscard(void);
+#if defined(__PIC32MX__) && defined(_ETH) && !defined(ENC100_INTERFACE_MODE) && !defined(ENC_CS_TRIS) && !defined(WF_CS_TRIS)
+	QWORD UDPGetRxTimestamp(void);
+#endif
 BOOL UDPIsOpened(UDP_SOCKET socket);
 
 /*****************************************************************************
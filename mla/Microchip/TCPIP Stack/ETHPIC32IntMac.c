@@ -73,11 +73,18 @@ static int		_LinkReconfigure(void);						// link reconfiguration
 
 static void*    _MacAllocCallback( size_t nitems, size_t size, void* param );
 
+static void		_RxAcknowledgeBuffer(void* pBuff);				// acknowledge RX buffer and maintain RX timestamps
+static void		_EthInterruptEnable(void);					// enable the Ethernet interrupt used for timestamps
+
 
 // TX buffers
 static volatile sEthTxDcpt	_TxDescriptors[EMAC_TX_DESCRIPTORS];			// the statically allocated TX buffers
 static volatile sEthTxDcpt*	_pTxCurrDcpt=0;						// the current TX buffer
 static int			_TxLastDcptIx=0;					// the last TX descriptor used
+static volatile sEthTxDcpt*	_pTxFlushedDcpt=0;					// the last TX buffer flushed
+static volatile sEthTxDcpt*	_pTxDeferredDcpt=0;					// the TX buffer flushed but not yet transmitted
+static unsigned short int	_TxDeferredSize=0;					// the deferred TX buffer size
+static int			_TxDeferNextFlush=0;					// if the next flush is to be deferred
 static unsigned short int	_TxCurrSize=0;						// the current TX buffer size
 
 
@@ -87,6 +94,21 @@ static unsigned char*		_pRxCurrBuff=0;						// the current RX buffer
 static unsigned short int	_RxCurrSize=0;						// the current RX buffer size
 
 
+// RX timestamps
+static QWORD			(*_RxTimestampFunction)(void)=0;			// timestamp function, 0 if RX timestamping disabled
+static volatile QWORD		_RxTimestamps[EMAC_RX_DESCRIPTORS];			// timestamps indexed by received packet count
+static volatile unsigned int	_RxStampedCount=0;					// number of received packets timestamped
+static unsigned int		_RxAckedCount=0;					// number of received packets acknowledged
+static unsigned int		_RxFetchedCount=0;					// number of received packets fetched by MACGetHeader
+static QWORD			_RxCurrTimestamp=0;					// timestamp of the current RX buffer
+
+
+// TX timestamps
+static QWORD			(*_TxTimestampFunction)(void)=0;			// timestamp function, 0 if TX timestamping disabled
+static volatile sEthTxDcpt*	_pTxStampDcpt=0;					// the deferred TX buffer transmitted but not yet timestamped
+static volatile QWORD		_TxDeferredTimestamp=0;					// timestamp of the last deferred TX buffer transmitted, 0 if not yet transmitted
+
+
 
 // HTTP +SSL buffers
 static unsigned char		_HttpSSlBuffer[RESERVED_HTTP_MEMORY+RESERVED_SSL_MEMORY];
@@ -217,7 +239,12 @@ void MACInit(void)
 		// let the auto-negotiation (if any) take place
 		// continue the initialization
 		EthRxFiltersClr(ETH_FILT_ALL_FILTERS);
+#if defined(STACK_USE_IGMP)
+		// multicast frames are accepted only for joined groups, through the hash table filter
+		EthRxFiltersSet(ETH_FILT_CRC_ERR_REJECT|ETH_FILT_RUNT_REJECT|ETH_FILT_ME_UCAST_ACCEPT|ETH_FILT_BCAST_ACCEPT);
+#else
 		EthRxFiltersSet(ETH_FILT_CRC_ERR_REJECT|ETH_FILT_RUNT_REJECT|ETH_FILT_ME_UCAST_ACCEPT|ETH_FILT_MCAST_ACCEPT|ETH_FILT_BCAST_ACCEPT);
+#endif
 
 		
 		// set the MAC address
@@ -422,8 +449,11 @@ PTR_BASE MACSetWritePtr(PTR_BASE address)
 BOOL MACIsTxReady(void)
 {
 	int	ix;
+	unsigned int	intStat;
 
+	intStat=INTDisableInterrupts();				// TX buffers may be transmitted from an interrupt
 	EthTxAcknowledgeBuffer(0, _TxAckCallback, 0);		// acknowledge everything
+	INTRestoreInterrupts(intStat);
 
 	if(_pTxCurrDcpt==0)
 	{
@@ -502,6 +532,155 @@ void MACPutArray(BYTE *buff, WORD len)
 }
 
 
+/******************************************************************************
+ * Function:        BOOL MACIsTxComplete(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          TRUE: If the last flushed TX buffer has been transmitted
+ *                  FALSE: the last flushed TX buffer is still being transmitted
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Acknowledges the transmitted TX buffers and checks if the
+ *                  packet sent by the last call to MACFlush has been
+ *                  transmitted.
+ *
+ * Note:            The application may poll this function immediately after
+ *                  MACFlush to obtain the time at which a packet completes
+ *                  transmission.  This is independent of the software latency
+ *                  of building the packet and of waiting for a TX descriptor.
+ *****************************************************************************/
+BOOL MACIsTxComplete(void)
+{
+	unsigned int	intStat;
+
+	intStat=INTDisableInterrupts();				// TX buffers may be transmitted from an interrupt
+	EthTxAcknowledgeBuffer(0, _TxAckCallback, 0);		// acknowledge everything
+	INTRestoreInterrupts(intStat);
+
+	return _pTxFlushedDcpt==0 || _pTxFlushedDcpt->txBusy==0;
+}
+
+
+/******************************************************************************
+ * Function:        void MACSetRxTimestampFunction(QWORD (*timestampFunction)(void))
+ *
+ * PreCondition:    MACInit() must have been called.
+ *
+ * Input:           timestampFunction - function returning the current time
+ *
+ * Output:          None
+ *
+ * Side Effects:    Enables the Ethernet interrupt
+ *
+ * Overview:        Enables RX timestamping.  The timestamp function is called
+ *                  from the Ethernet RX done interrupt and so the time of
+ *                  arrival of each packet is independent of when the stack
+ *                  gets around to calling MACGetHeader.
+ *
+ * Note:            The timestamp function must be safe to call from an
+ *                  interrupt of priority 6.
+ *****************************************************************************/
+void MACSetRxTimestampFunction(QWORD (*timestampFunction)(void))
+{
+	_RxTimestampFunction=timestampFunction;
+
+	EthEventsClr(ETH_EV_RXDONE);
+	EthEventsEnableSet(ETH_EV_RXDONE);
+	_EthInterruptEnable();
+}
+
+/******************************************************************************
+ * Function:        void MACSetTxTimestampFunction(QWORD (*timestampFunction)(void))
+ *
+ * PreCondition:    MACInit() must have been called.
+ *
+ * Input:           timestampFunction - function returning the current time
+ *
+ * Output:          None
+ *
+ * Side Effects:    Enables the Ethernet interrupt
+ *
+ * Overview:        Enables TX timestamping of deferred TX buffers.  The
+ *                  timestamp function is called from the Ethernet TX done
+ *                  interrupt and so the time at which a deferred TX buffer
+ *                  completes transmission may be obtained by
+ *                  MACGetDeferredTxTimestamp() without polling.
+ *
+ * Note:            The timestamp function must be safe to call from an
+ *                  interrupt of priority 6.
+ *****************************************************************************/
+void MACSetTxTimestampFunction(QWORD (*timestampFunction)(void))
+{
+	_TxTimestampFunction=timestampFunction;
+
+	EthEventsClr(ETH_EV_TXDONE);
+	EthEventsEnableSet(ETH_EV_TXDONE);
+	_EthInterruptEnable();
+}
+
+/******************************************************************************
+ * Function:        QWORD MACGetDeferredTxTimestamp(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          Timestamp of the last deferred TX buffer transmitted
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Returns the time at which the TX buffer last transmitted
+ *                  by MACTransmitDeferred() completed transmission.
+ *
+ * Note:            Returns 0 if the TX buffer has not yet completed
+ *                  transmission or if TX timestamping has not been enabled by
+ *                  MACSetTxTimestampFunction().  May be called from an
+ *                  interrupt.  The timestamp is written by the Ethernet
+ *                  interrupt and a 64 bit read is not atomic so it is read
+ *                  with the Ethernet interrupt disabled.
+ *****************************************************************************/
+QWORD MACGetDeferredTxTimestamp(void)
+{
+	unsigned int	intStat;
+	QWORD		timestamp;
+
+	intStat=INTGetEnable(INT_ETHERNET);
+	INTEnable(INT_ETHERNET, INT_DISABLED);
+
+	timestamp=_TxDeferredTimestamp;
+
+	INTEnable(INT_ETHERNET, (INT_EN_DIS)intStat);
+
+	return timestamp;
+}
+
+/******************************************************************************
+ * Function:        QWORD MACGetRxTimestamp(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          Timestamp of the current RX buffer
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Returns the time of arrival of the packet obtained by the
+ *                  last call to MACGetHeader().
+ *
+ * Note:            Returns 0 if RX timestamping has not been enabled by
+ *                  MACSetRxTimestampFunction().
+ *****************************************************************************/
+QWORD MACGetRxTimestamp(void)
+{
+	return _RxCurrTimestamp;
+}
+
+
 /******************************************************************************
  * Function:        void MACPutHeader(MAC_ADDR *remote, BYTE type, WORD dataLen)
  *
@@ -541,17 +720,126 @@ void MACPutHeader(MAC_ADDR *remote, BYTE type, WORD dataLen)
 
 void MACFlush(void)
 {
+	unsigned int	intStat;
+
 	if(_pTxCurrDcpt && _TxCurrSize)
 	{	// there is a buffer to transmit
 		_pTxCurrDcpt->txBusy=1;	
-		EthTxSendBuffer((void*)_pTxCurrDcpt->dataBuff, _TxCurrSize);
-		// res should be ETH_RES_OK since we made sure we had a descriptor available
-		// by the call to MACIsTxReady and the number of the buffers matches the number of descriptors
+		if(_TxDeferNextFlush)
+		{	// hold the buffer until MACTransmitDeferred() is called
+			_pTxDeferredDcpt=_pTxCurrDcpt;
+			_TxDeferredSize=_TxCurrSize;
+			_TxDeferNextFlush=0;
+		}
+		else
+		{
+			intStat=INTDisableInterrupts();		// TX buffers may be transmitted from an interrupt
+			EthTxSendBuffer((void*)_pTxCurrDcpt->dataBuff, _TxCurrSize);
+			// res should be ETH_RES_OK since we made sure we had a descriptor available
+			// by the call to MACIsTxReady and the number of the buffers matches the number of descriptors
+			_pTxFlushedDcpt=_pTxCurrDcpt;
+			INTRestoreInterrupts(intStat);
+		}
 		_pTxCurrDcpt=0;
 		_TxCurrSize=0;
 	}
 }
 
+/******************************************************************************
+ * Function:        BOOL MACDeferNextFlush(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          TRUE: If the next flush will be deferred
+ *                  FALSE: a deferred TX buffer has not yet been transmitted
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Causes the next call to MACFlush() to hold the TX buffer
+ *                  instead of transmitting it.  The complete frame may then be
+ *                  modified using MACGetDeferredTxBuffer() and transmitted with
+ *                  minimal latency by MACTransmitDeferred().
+ *
+ * Note:            The deferred TX buffer remains busy until transmitted and so
+ *                  an additional TX descriptor should be provided.
+ *****************************************************************************/
+BOOL MACDeferNextFlush(void)
+{
+	if(_pTxDeferredDcpt)
+	{
+		return FALSE;
+	}
+	_TxDeferNextFlush=1;
+	return TRUE;
+}
+
+/******************************************************************************
+ * Function:        BYTE* MACGetDeferredTxBuffer(WORD* len)
+ *
+ * PreCondition:    None
+ *
+ * Input:           len - Location to store the frame size
+ *
+ * Output:          Address of the deferred frame, starting with the Ethernet
+ *                  header.  0 if there is no deferred TX buffer.
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Gets the TX buffer held by a deferred flush so that the
+ *                  frame may be modified before it is transmitted.
+ *
+ * Note:            May be called from an interrupt.
+ *****************************************************************************/
+BYTE* MACGetDeferredTxBuffer(WORD* len)
+{
+	volatile sEthTxDcpt*	pDcpt=_pTxDeferredDcpt;
+
+	if(pDcpt==0)
+	{
+		*len=0;
+		return 0;
+	}
+	*len=_TxDeferredSize;
+	return (BYTE*)pDcpt->dataBuff;
+}
+
+/******************************************************************************
+ * Function:        BOOL MACTransmitDeferred(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          TRUE: If the deferred TX buffer was transmitted
+ *                  FALSE: there is no deferred TX buffer
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Transmits the TX buffer held by a deferred flush.
+ *
+ * Note:            May be called from an interrupt.  All other accesses to the
+ *                  TX descriptors are made with interrupts disabled.
+ *****************************************************************************/
+BOOL MACTransmitDeferred(void)
+{
+	unsigned int	intStat;
+
+	if(_pTxDeferredDcpt==0)
+	{
+		return FALSE;
+	}
+	intStat=INTDisableInterrupts();
+	EthTxSendBuffer((void*)_pTxDeferredDcpt->dataBuff, _TxDeferredSize);
+	_pTxFlushedDcpt=_pTxDeferredDcpt;
+	_pTxStampDcpt=_pTxDeferredDcpt;
+	_TxDeferredTimestamp=0;
+	_pTxDeferredDcpt=0;
+	INTRestoreInterrupts(intStat);
+	return TRUE;
+}
+
 /**************************
  * RX functions
  ***********************************************/
@@ -581,7 +869,7 @@ void MACDiscardRx(void)
 {
 	if(_pRxCurrBuff)
 	{	// an already existing packet
-		EthRxAcknowledgeBuffer(_pRxCurrBuff, 0, 0);
+		_RxAcknowledgeBuffer(_pRxCurrBuff);
 		_pRxCurrBuff=0;
 		_RxCurrSize=0;
 
@@ -678,9 +966,22 @@ BOOL MACGetHeader(MAC_ADDR *remote, BYTE* type)
 		}
 	}
 
+	if(res==ETH_RES_OK)
+	{	// get the timestamp of the new packet
+		if((int)(_RxStampedCount-_RxFetchedCount)>0)
+		{	// already timestamped by the interrupt
+			_RxCurrTimestamp=_RxTimestamps[_RxFetchedCount%EMAC_RX_DESCRIPTORS];
+		}
+		else
+		{	// interrupt not yet serviced or RX timestamping disabled
+			_RxCurrTimestamp=_RxTimestampFunction?_RxTimestampFunction():0;
+		}
+		_RxFetchedCount++;
+	}
+
 	if(_pRxCurrBuff==0 && pNewPkt)
 	{	// failed packet, discard
-		EthRxAcknowledgeBuffer(pNewPkt, 0, 0);
+		_RxAcknowledgeBuffer(pNewPkt);
 		_stackMgrRxBadPkts++;
 	}
 		
@@ -991,7 +1292,7 @@ WORD MACCalcRxChecksum(WORD offset, WORD len)
  *                  This will allow you to then readd the necessary destination 
  *                  addresses.
  *****************************************************************************/
-#if defined(STACK_USE_ZEROCONF_MDNS_SD)
+#if defined(STACK_USE_ZEROCONF_MDNS_SD) || defined(STACK_USE_IGMP)
 void SetRXHashTableEntry(MAC_ADDR DestMACAddr)
 {
       volatile unsigned int*    pHTSet;
@@ -1080,6 +1381,123 @@ static void	_TxAckCallback(void* pPktBuff, int buffIx, void* fParam)
 
 }
 
+/*********************************************************************
+* Function:        void _RxAcknowledgeBuffer(void* pBuff)
+ *
+ * PreCondition:    None
+ * 
+ * Input:           pBuff - rx buffer to be acknowledged
+ * 
+ * Output:          None
+ * 
+ * Side Effects:    None
+ * 
+ * Overview:        Acknowledges an RX buffer to the Eth MAC.
+ *                  The acknowledge decrements the ETHC packet buffer count and
+ *                  so the acknowledged count must be updated with the
+ *                  Ethernet interrupt disabled to keep the sum of the two
+ *                  equal to the number of packets received.
+ * 
+ * Note:            None
+ ********************************************************************/
+static void _RxAcknowledgeBuffer(void* pBuff)
+{
+	unsigned int	intStat;
+
+	intStat=INTGetEnable(INT_ETHERNET);
+	INTEnable(INT_ETHERNET, INT_DISABLED);
+
+	EthRxAcknowledgeBuffer(pBuff, 0, 0);
+	_RxAckedCount++;
+
+	INTEnable(INT_ETHERNET, (INT_EN_DIS)intStat);
+}
+
+/*********************************************************************
+* Function:        void _EthInterruptEnable(void)
+ *
+ * PreCondition:    MACInit() must have been called.
+ * 
+ * Input:           None
+ * 
+ * Output:          None
+ * 
+ * Side Effects:    None
+ * 
+ * Overview:        Enables the Ethernet interrupt used for RX and TX
+ *                  timestamps.
+ * 
+ * Note:            None
+ ********************************************************************/
+static void _EthInterruptEnable(void)
+{
+	INTSetVectorPriority(INT_ETH_VECTOR, INT_PRIORITY_LEVEL_6);
+	INTSetVectorSubPriority(INT_ETH_VECTOR, INT_SUB_PRIORITY_LEVEL_3);
+	INTClearFlag(INT_ETHERNET);
+	INTEnable(INT_ETHERNET, INT_ENABLED);
+}
+
+/*********************************************************************
+* Function:        void _EthInterrupt(void)
+ *
+ * PreCondition:    MACSetRxTimestampFunction() or MACSetTxTimestampFunction()
+ *                  must have been called.
+ * 
+ * Input:           None
+ * 
+ * Output:          None
+ * 
+ * Side Effects:    None
+ * 
+ * Overview:        Ethernet interrupt.  Timestamps every packet received
+ *                  since the last interrupt.  The number of packets received
+ *                  is the number acknowledged plus the ETHC packet buffer
+ *                  count.  Timestamps the deferred TX buffer once it has
+ *                  been transmitted.
+ * 
+ * Note:            The events are cleared before the packet buffer count is
+ *                  read, or the TX buffers are acknowledged, so that a packet
+ *                  received or transmitted during the interrupt will cause
+ *                  another interrupt.  The TX buffers may already have been
+ *                  acknowledged by the main program loop, which does so with
+ *                  interrupts disabled, and so the deferred TX buffer is
+ *                  timestamped if it is no longer busy.
+ ********************************************************************/
+void __attribute__((interrupt(), vector(_ETH_VECTOR))) _EthInterrupt(void)
+{
+	QWORD		timestamp;
+	unsigned int	receivedCount;
+	eEthEvents	events;
+
+	events=EthEventsGet();
+
+	if(_TxTimestampFunction && (events&ETH_EV_TXDONE))
+	{
+		timestamp=_TxTimestampFunction();
+		EthEventsClr(ETH_EV_TXDONE);
+		EthTxAcknowledgeBuffer(0, _TxAckCallback, 0);
+		if(_pTxStampDcpt && _pTxStampDcpt->txBusy==0)
+		{
+			_TxDeferredTimestamp=timestamp;
+			_pTxStampDcpt=0;
+		}
+	}
+
+	if(_RxTimestampFunction && (events&ETH_EV_RXDONE))
+	{
+		timestamp=_RxTimestampFunction();
+		EthEventsClr(ETH_EV_RXDONE);
+		receivedCount=_RxAckedCount+ETHSTATbits.BUFCNT;
+		while(_RxStampedCount!=receivedCount)
+		{
+			_RxTimestamps[_RxStampedCount%EMAC_RX_DESCRIPTORS]=timestamp;
+			_RxStampedCount++;
+		}
+	}
+
+	INTClearFlag(INT_ETHERNET);
+}
+
 /*********************************************************************
 * Function:        void* _MacAllocCallback( size_t nitems, size_t size, void* param )
  *
@@ -0,0 +1,518 @@
+/*********************************************************************
+ *
+ *  Internet Group Management Protocol (IGMP) Host
+ *  Module for Microchip TCP/IP Stack
+ *   -Joins and leaves IPv4 multicast groups
+ *   -Answers membership queries from multicast routers and
+ *    IGMP snooping switches
+ *	 -Reference: RFC 2236 (IGMPv2), RFC 1112 (IGMPv1)
+ *
+ *********************************************************************
+ * FileName:        IGMP.c
+ * Dependencies:    IP, MAC
+ * Processor:       PIC32
+ * Compiler:        Microchip C32 v1.05 or higher
+ *
+ * Note:            Multicast frames are received through the MAC
+ *                  hash table filter.  Each joined group and the
+ *                  all-hosts group 224.0.0.1 are added to the hash
+ *                  table using SetRXHashTableEntry().
+ ********************************************************************/
+#define __IGMP_C
+
+#include "TCPIP Stack/TCPIP.h"
+
+#if defined(STACK_USE_IGMP)
+
+// IGMP message types
+#define IGMP_MEMBERSHIP_QUERY		(0x11u)
+#define IGMP_V1_MEMBERSHIP_REPORT	(0x12u)
+#define IGMP_V2_MEMBERSHIP_REPORT	(0x16u)
+#define IGMP_LEAVE_GROUP			(0x17u)
+
+// Number of unsolicited reports sent when a group is joined or the
+// link comes up (Robustness Variable, RFC 2236 section 8.1)
+#define IGMP_UNSOLICITED_REPORT_COUNT		(2u)
+
+// Maximum delay between unsolicited reports (RFC 2236 section 8.10)
+#define IGMP_UNSOLICITED_REPORT_INTERVAL	(10ul*TICK_SECOND)
+
+// Maximum response time assumed for IGMPv1 queries, which do not
+// specify one (RFC 2236 section 4)
+#define IGMP_V1_MAX_RESPONSE_TIME			(10ul*TICK_SECOND)
+
+// Time after the last IGMPv1 query for which IGMPv1 reports are sent
+// and leave messages are suppressed (RFC 2236 section 8.11)
+#define IGMP_V1_ROUTER_PRESENT_TIMEOUT		(400ul*TICK_SECOND)
+
+// 224.0.0.1 and 224.0.0.2 in network byte order
+#define IGMP_ALL_HOSTS_ADDR			(0x010000E0ul)
+#define IGMP_ALL_ROUTERS_ADDR		(0x020000E0ul)
+
+// IP version 4 with a 24 byte header (20 byte header and a 4 byte
+// Router Alert option)
+#define IGMP_IP_VERSION_IHL			(0x46u)
+
+// IGMP packet structure
+typedef struct
+{
+	BYTE vType;
+	BYTE vMaxResponseTime;		// in 1/10 second units
+	WORD wChecksum;
+	IP_ADDR GroupAddr;
+} IGMP_PACKET;
+
+// IP header with Router Alert option, which must be included in all
+// IGMPv2 messages (RFC 2236 section 2)
+typedef struct
+{
+	IP_HEADER Header;
+	BYTE vRouterAlert[4];
+} IGMP_IP_HEADER;
+
+// State of a joined group
+typedef struct
+{
+	IP_ADDR GroupAddr;			// 0.0.0.0 if not in use
+	DWORD dwReportTime;			// TickGet() value when the next report is due
+	BYTE vReportsPending;		// number of reports still to be sent
+	unsigned char bLastReporter:1;	// we sent the last report for this group
+} IGMP_GROUP;
+
+static IGMP_GROUP IGMPGroups[IGMP_MAX_GROUPS];
+static DWORD dwV1RouterTime;
+static WORD wIdentifier;
+static struct
+{
+	unsigned char bV1RouterPresent:1;
+	unsigned char bWasLinked:1;
+} IGMPFlags;
+
+static void IGMPUpdateRxFilter(void);
+static void IGMPScheduleReport(IGMP_GROUP *group, DWORD dwMaxDelay);
+static BOOL IGMPSendMessage(BYTE vType, IP_ADDR GroupAddr, IP_ADDR DestAddr);
+
+
+/*********************************************************************
+ * Function:        void IGMPInit(void)
+ *
+ * PreCondition:    MACInit() is already called.
+ *
+ * Input:           None
+ *
+ * Output:          All groups are left and the all-hosts group is
+ *                  added to the MAC hash table filter.
+ *
+ * Side Effects:    None
+ *
+ * Overview:        None
+ *
+ * Note:            None
+ ********************************************************************/
+void IGMPInit(void)
+{
+	memset((void*)IGMPGroups, 0x00, sizeof(IGMPGroups));
+	IGMPFlags.bV1RouterPresent = 0;
+	IGMPFlags.bWasLinked = 0;
+	IGMPUpdateRxFilter();
+}
+
+
+/*********************************************************************
+ * Function:        void IGMPTask(void)
+ *
+ * PreCondition:    IGMPInit() is already called.
+ *
+ * Input:           None
+ *
+ * Output:          Membership reports that are due are sent.
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Unsolicited reports are resent for every joined
+ *                  group each time the link comes up so that
+ *                  snooping switches forward the group to this port
+ *                  without waiting for the next query.
+ *
+ * Note:            A report that cannot be sent because the TX
+ *                  buffer is busy is sent on a later call.
+ ********************************************************************/
+void IGMPTask(void)
+{
+	BYTE i;
+	BOOL bIsLinked;
+	IGMP_GROUP *group;
+
+	bIsLinked = MACIsLinked();
+	if(bIsLinked && !IGMPFlags.bWasLinked)
+	{
+		for(i = 0; i < IGMP_MAX_GROUPS; i++)
+		{
+			if(IGMPGroups[i].GroupAddr.Val == 0u)
+				continue;
+			IGMPGroups[i].vReportsPending = IGMP_UNSOLICITED_REPORT_COUNT;
+			IGMPGroups[i].dwReportTime = TickGet();
+		}
+	}
+	IGMPFlags.bWasLinked = bIsLinked;
+	if(!bIsLinked)
+		return;
+
+	if(IGMPFlags.bV1RouterPresent && ((TickGet() - dwV1RouterTime) > IGMP_V1_ROUTER_PRESENT_TIMEOUT))
+		IGMPFlags.bV1RouterPresent = 0;
+
+	for(i = 0; i < IGMP_MAX_GROUPS; i++)
+	{
+		group = &IGMPGroups[i];
+		if((group->GroupAddr.Val == 0u) || (group->vReportsPending == 0u))
+			continue;
+		if((LONG)(TickGet() - group->dwReportTime) < 0)
+			continue;
+		if(!IGMPSendMessage(IGMPFlags.bV1RouterPresent ? IGMP_V1_MEMBERSHIP_REPORT : IGMP_V2_MEMBERSHIP_REPORT, group->GroupAddr, group->GroupAddr))
+			return;
+		group->bLastReporter = 1;
+		if(--group->vReportsPending != 0u)
+			IGMPScheduleReport(group, IGMP_UNSOLICITED_REPORT_INTERVAL);
+	}
+}
+
+
+/*********************************************************************
+ * Function:        void IGMPProcess(WORD len)
+ *
+ * PreCondition:    MAC buffer contains IGMP type packet and the read
+ *                  pointer is at the start of the IGMP message.
+ *
+ * Input:           len: Count of how many bytes the IGMP message is
+ *
+ * Output:          None
+ *
+ * Side Effects:    None
+ *
+ * Overview:        A membership query schedules a report for each
+ *                  queried group at a random time within the maximum
+ *                  response time.  A report from another member
+ *                  cancels our pending report for that group.
+ *
+ * Note:            IGMPv3 queries are longer than 8 bytes and are
+ *                  treated as IGMPv2 queries (RFC 3376 section 7.2.1).
+ ********************************************************************/
+void IGMPProcess(WORD len)
+{
+	BYTE i;
+	DWORD dwMaxDelay;
+	IGMP_PACKET packet;
+	IGMP_GROUP *group;
+
+	if(len < sizeof(IGMP_PACKET))
+		return;
+
+	// A valid message, including its checksum field, has a checksum
+	// of 0x0000
+	if(CalcIPBufferChecksum(len))
+		return;
+	MACGetArray((BYTE*)&packet, sizeof(packet));
+
+	switch(packet.vType)
+	{
+		case IGMP_MEMBERSHIP_QUERY:
+			if(packet.vMaxResponseTime == 0u)
+			{
+				IGMPFlags.bV1RouterPresent = 1;
+				dwV1RouterTime = TickGet();
+				dwMaxDelay = IGMP_V1_MAX_RESPONSE_TIME;
+			}
+			else
+			{
+				dwMaxDelay = packet.vMaxResponseTime * (TICK_SECOND/10);
+			}
+			for(i = 0; i < IGMP_MAX_GROUPS; i++)
+			{
+				group = &IGMPGroups[i];
+				if(group->GroupAddr.Val == 0u)
+					continue;
+				if((packet.GroupAddr.Val != 0u) && (packet.GroupAddr.Val != group->GroupAddr.Val))
+					continue;	// group-specific query for another group
+
+				// Only reschedule if this would send the report sooner
+				if((group->vReportsPending != 0u) && ((LONG)(group->dwReportTime - (TickGet() + dwMaxDelay)) < 0))
+					continue;
+				group->vReportsPending = 1;
+				IGMPScheduleReport(group, dwMaxDelay);
+			}
+			break;
+
+		case IGMP_V1_MEMBERSHIP_REPORT:
+		case IGMP_V2_MEMBERSHIP_REPORT:
+			for(i = 0; i < IGMP_MAX_GROUPS; i++)
+			{
+				group = &IGMPGroups[i];
+				if((group->GroupAddr.Val == 0u) || (group->GroupAddr.Val != packet.GroupAddr.Val))
+					continue;
+				if(group->vReportsPending != 0u)
+				{
+					group->vReportsPending = 0;
+					group->bLastReporter = 0;
+				}
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+/*********************************************************************
+ * Function:        BOOL IGMPJoinGroup(IP_ADDR GroupAddr)
+ *
+ * PreCondition:    IGMPInit() is already called.
+ *
+ * Input:           GroupAddr: Multicast group address to join
+ *
+ * Output:          TRUE if the group is joined
+ *                  FALSE if GroupAddr is not a multicast address or
+ *                  IGMP_MAX_GROUPS groups are already joined
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The group MAC address is added to the MAC hash
+ *                  table filter and unsolicited reports are sent by
+ *                  IGMPTask().
+ *
+ * Note:            Joining a group that is already joined has no
+ *                  effect.
+ ********************************************************************/
+BOOL IGMPJoinGroup(IP_ADDR GroupAddr)
+{
+	BYTE i;
+	MAC_ADDR MACAddr;
+	IGMP_GROUP *group;
+
+	if(!IGMPIsMulticastAddr(GroupAddr))
+		return FALSE;
+	if(GroupAddr.Val == IGMP_ALL_HOSTS_ADDR)
+		return TRUE;	// always joined and never reported
+
+	group = NULL;
+	for(i = 0; i < IGMP_MAX_GROUPS; i++)
+	{
+		if(IGMPGroups[i].GroupAddr.Val == GroupAddr.Val)
+			return TRUE;
+		if((group == NULL) && (IGMPGroups[i].GroupAddr.Val == 0u))
+			group = &IGMPGroups[i];
+	}
+	if(group == NULL)
+		return FALSE;
+
+	group->GroupAddr = GroupAddr;
+	group->vReportsPending = IGMP_UNSOLICITED_REPORT_COUNT;
+	group->dwReportTime = TickGet();
+	group->bLastReporter = 0;
+	IGMPGetGroupMACAddr(GroupAddr, &MACAddr);
+	SetRXHashTableEntry(MACAddr);
+	return TRUE;
+}
+
+
+/*********************************************************************
+ * Function:        void IGMPLeaveGroup(IP_ADDR GroupAddr)
+ *
+ * PreCondition:    IGMPInit() is already called.
+ *
+ * Input:           GroupAddr: Multicast group address to leave
+ *
+ * Output:          None
+ *
+ * Side Effects:    The MAC hash table is rebuilt, removing any
+ *                  entries added by other modules.
+ *
+ * Overview:        A leave message is sent to the all-routers group
+ *                  if we sent the last report for the group and no
+ *                  IGMPv1 router is present (RFC 2236 section 3).
+ *
+ * Note:            The leave message is not sent if the TX buffer is
+ *                  busy.  The router will then remove the membership
+ *                  once it times out.
+ ********************************************************************/
+void IGMPLeaveGroup(IP_ADDR GroupAddr)
+{
+	BYTE i;
+	IP_ADDR AllRoutersAddr;
+
+	for(i = 0; i < IGMP_MAX_GROUPS; i++)
+	{
+		if((IGMPGroups[i].GroupAddr.Val == 0u) || (IGMPGroups[i].GroupAddr.Val != GroupAddr.Val))
+			continue;
+		if(IGMPGroups[i].bLastReporter && !IGMPFlags.bV1RouterPresent && MACIsLinked())
+		{
+			AllRoutersAddr.Val = IGMP_ALL_ROUTERS_ADDR;
+			IGMPSendMessage(IGMP_LEAVE_GROUP, GroupAddr, AllRoutersAddr);
+		}
+		memset((void*)&IGMPGroups[i], 0x00, sizeof(IGMPGroups[i]));
+		IGMPUpdateRxFilter();
+		return;
+	}
+}
+
+
+/*********************************************************************
+ * Function:        void IGMPGetGroupMACAddr(IP_ADDR GroupAddr,
+ *                                           MAC_ADDR *MACAddr)
+ *
+ * PreCondition:    None
+ *
+ * Input:           GroupAddr: Multicast group address
+ *                  MACAddr: Location to write the MAC address
+ *
+ * Output:          Ethernet MAC address that the group maps to
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The low order 23 bits of the group address are
+ *                  placed in the low order 23 bits of the MAC address
+ *                  01-00-5E-00-00-00 (RFC 1112 section 6.4).
+ *
+ * Note:            This may be used to open a UDP socket to a
+ *                  multicast group with UDP_OPEN_NODE_INFO, which
+ *                  skips the ARP resolution that would otherwise
+ *                  never complete.
+ ********************************************************************/
+void IGMPGetGroupMACAddr(IP_ADDR GroupAddr, MAC_ADDR *MACAddr)
+{
+	MACAddr->v[0] = 0x01;
+	MACAddr->v[1] = 0x00;
+	MACAddr->v[2] = 0x5E;
+	MACAddr->v[3] = GroupAddr.v[1] & 0x7F;
+	MACAddr->v[4] = GroupAddr.v[2];
+	MACAddr->v[5] = GroupAddr.v[3];
+}
+
+
+/*********************************************************************
+ * Function:        static void IGMPUpdateRxFilter(void)
+ *
+ * PreCondition:    None
+ *
+ * Input:           None
+ *
+ * Output:          The MAC hash table contains the all-hosts group and
+ *                  every joined group.
+ *
+ * Side Effects:    None
+ *
+ * Overview:        Hash table entries cannot be removed individually
+ *                  as several addresses may share an entry, so the
+ *                  table is cleared and rebuilt.
+ *
+ * Note:            None
+ ********************************************************************/
+static void IGMPUpdateRxFilter(void)
+{
+	BYTE i;
+	IP_ADDR AllHostsAddr;
+	MAC_ADDR MACAddr;
+
+	memset((void*)&MACAddr, 0x00, sizeof(MACAddr));
+	SetRXHashTableEntry(MACAddr);
+	AllHostsAddr.Val = IGMP_ALL_HOSTS_ADDR;
+	IGMPGetGroupMACAddr(AllHostsAddr, &MACAddr);
+	SetRXHashTableEntry(MACAddr);
+	for(i = 0; i < IGMP_MAX_GROUPS; i++)
+	{
+		if(IGMPGroups[i].GroupAddr.Val == 0u)
+			continue;
+		IGMPGetGroupMACAddr(IGMPGroups[i].GroupAddr, &MACAddr);
+		SetRXHashTableEntry(MACAddr);
+	}
+}
+
+
+/*********************************************************************
+ * Function:        static void IGMPScheduleReport(IGMP_GROUP *group,
+ *                                                 DWORD dwMaxDelay)
+ *
+ * PreCondition:    None
+ *
+ * Input:           group: Group to report
+ *                  dwMaxDelay: Maximum delay in ticks
+ *
+ * Output:          The next report for the group is due at a random
+ *                  time within dwMaxDelay.
+ *
+ * Side Effects:    None
+ *
+ * Overview:        A random delay avoids every member on the network
+ *                  reporting at the same time.
+ *
+ * Note:            None
+ ********************************************************************/
+static void IGMPScheduleReport(IGMP_GROUP *group, DWORD dwMaxDelay)
+{
+	group->dwReportTime = TickGet() + (((dwMaxDelay >> 8) * LFSRRand()) >> 8);
+}
+
+
+/*********************************************************************
+ * Function:        static BOOL IGMPSendMessage(BYTE vType,
+ *                                              IP_ADDR GroupAddr,
+ *                                              IP_ADDR DestAddr)
+ *
+ * PreCondition:    None
+ *
+ * Input:           vType: IGMP message type
+ *                  GroupAddr: Group address field of the message
+ *                  DestAddr: Destination multicast address
+ *
+ * Output:          TRUE if the message was sent
+ *                  FALSE if the TX buffer is busy
+ *
+ * Side Effects:    None
+ *
+ * Overview:        The IP header is written here rather than by
+ *                  IPPutHeader() as IGMP messages must be sent with a
+ *                  TTL of 1 and the Router Alert option.
+ *
+ * Note:            None
+ ********************************************************************/
+static BOOL IGMPSendMessage(BYTE vType, IP_ADDR GroupAddr, IP_ADDR DestAddr)
+{
+	MAC_ADDR MACAddr;
+	IGMP_IP_HEADER header;
+	IGMP_PACKET packet;
+
+	if(!IPIsTxReady())
+		return FALSE;
+
+	packet.vType = vType;
+	packet.vMaxResponseTime = 0;
+	packet.wChecksum = 0;
+	packet.GroupAddr = GroupAddr;
+	packet.wChecksum = CalcIPChecksum((BYTE*)&packet, sizeof(packet));
+
+	header.Header.VersionIHL = IGMP_IP_VERSION_IHL;
+	header.Header.TypeOfService = 0;
+	header.Header.TotalLength = swaps(sizeof(header) + sizeof(packet));
+	header.Header.Identification = swaps(++wIdentifier);
+	header.Header.FragmentInfo = 0;
+	header.Header.TimeToLive = 1;
+	header.Header.Protocol = IP_PROT_IGMP;
+	header.Header.HeaderChecksum = 0;
+	header.Header.SourceAddress = AppConfig.MyIPAddr;
+	header.Header.DestAddress = DestAddr;
+	header.vRouterAlert[0] = 0x94;	// Router Alert option, copied flag set
+	header.vRouterAlert[1] = 0x04;
+	header.vRouterAlert[2] = 0x00;
+	header.vRouterAlert[3] = 0x00;
+	header.Header.HeaderChecksum = CalcIPChecksum((BYTE*)&header, sizeof(header));
+
+	IGMPGetGroupMACAddr(DestAddr, &MACAddr);
+	MACSetWritePtr(BASE_TX_ADDR);
+	MACPutHeader(&MACAddr, MAC_IP, sizeof(header) + sizeof(packet));
+	MACPutArray((BYTE*)&header, sizeof(header));
+	MACPutArray((BYTE*)&packet, sizeof(packet));
+	MACFlush();
+	return TRUE;
+}
+
+#endif //#if defined(STACK_USE_IGMP)
@@ -146,6 +146,10 @@ void StackInit(void)
     UDPInit();
 #endif
 
+#if defined(STACK_USE_IGMP)
+    IGMPInit();
+#endif
+
 #if defined(STACK_USE_TCP)
     TCPInit();
 #endif
@@ -317,6 +321,11 @@ void StackTask(void)
 	UDPTask();
 	#endif
 
+	#if defined(STACK_USE_IGMP)
+	// Send IGMP membership reports that are due
+	IGMPTask();
+	#endif
+
 	// Process as many incomming packets as we can
 	while(1)
 	{
@@ -404,6 +413,14 @@ void StackTask(void)
 				}
 				#endif
 				
+				#if defined(STACK_USE_IGMP)
+				if(cIPFrameType == IP_PROT_IGMP)
+				{
+					IGMPProcess(dataCount);
+					break;
+				}
+				#endif
+
 				#if defined(STACK_USE_TCP)
 				if(cIPFrameType == IP_PROT_TCP)
 				{
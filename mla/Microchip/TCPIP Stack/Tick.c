@@ -58,6 +58,12 @@
 
 #include "TCPIP Stack/TCPIP.h"
 
+#if defined(__PIC32MX__)
+// PIC32 Ticks are a view onto the 64-bit timebase of the Timer module divided 
+// by 256 so that the stack and the application share one clock and no Timer1 
+// interrupt is required.
+#include "Timer/Timer.h"
+#else
 // Internal counter to store Ticks.  This variable is incremented in an ISR and 
 // therefore must be marked volatile to prevent the compiler optimizer from 
 // reordering code to use this value in the main context while interrupts are 
@@ -68,6 +74,7 @@ static volatile DWORD dwInternalTicks = 0;
 static volatile BYTE vTickReading[6] __attribute__ ((aligned));
 
 static void GetTickCopy(void);
+#endif
 
 
 /*****************************************************************************
@@ -108,8 +115,12 @@ void TickInit(void)
     // Timer0 on, 16-bit, internal timer, 1:256 prescalar
     T0CON = 0x87;
 
+#elif defined(__PIC32MX__)
+	// Use the Timer module timebase for PIC32.  TimerInitialise() must be 
+	// called before this function.
+
 #else
-	// Use Timer 1 for 16-bit and 32-bit processors
+	// Use Timer 1 for 16-bit processors
 	// 1:256 prescale
 	T1CONbits.TCKPS = 3;
 	// Base
@@ -118,21 +129,16 @@ void TickInit(void)
 	TMR1 = 0;
 
 	// Enable timer interrupt
-	#if defined(__C30__)
-		IPC0bits.T1IP = 2;	// Interrupt priority 2 (low)
-		IFS0bits.T1IF = 0;
-		IEC0bits.T1IE = 1;
-	#else
-		IPC1bits.T1IP = 2;	// Interrupt priority 2 (low)
-		IFS0CLR = _IFS0_T1IF_MASK;
-		IEC0SET = _IEC0_T1IE_MASK;
-	#endif
+	IPC0bits.T1IP = 2;	// Interrupt priority 2 (low)
+	IFS0bits.T1IF = 0;
+	IEC0bits.T1IE = 1;
 
 	// Start timer
 	T1CONbits.TON = 1;
 #endif
 }
 
+#if !defined(__PIC32MX__)
 /*****************************************************************************
   Function:
 	static void GetTickCopy(void)
@@ -198,49 +204,9 @@ static void GetTickCopy(void)
 		vTickReading[5] = ((BYTE*)&dwTempTicks)[3];
 	} while(IFS0bits.T1IF);
 	IEC0bits.T1IE = 1;				// Enable interrupt
-#else	// PIC32
-	do
-	{
-		DWORD dwTempTicks;
-        WORD_VAL wTemp;
-		
-		IEC0SET = _IEC0_T1IE_MASK;	// Enable interrupt
-		Nop();
-		IEC0CLR = _IEC0_T1IE_MASK;	// Disable interrupt
-		
-		// Get low 2 bytes
-        wTemp.Val = TMR1;
-        vTickReading[0] = wTemp.v[0];
-        vTickReading[1] = wTemp.v[1];
-		//((volatile WORD*)vTickReading)[0] = TMR1;
-		
-		// Correct corner case where interrupt increments byte[4+] but 
-		// TMR1 hasn't rolled over to 0x0000 yet
-		dwTempTicks = dwInternalTicks;
-
-		// PIC32MX3XX/4XX devices trigger the timer interrupt when TMR1 == PR1 
-		// (TMR1 prescalar is 0x00), requiring us to undo the ISR's increment 
-		// of the upper 32 bits of our 48 bit timer in the special case when 
-		// TMR1 == PR1 == 0xFFFF.  For other PIC32 families, the ISR is 
-		// triggered when TMR1 increments from PR1 to 0x0000, making no special 
-		// corner case.
-		#if __PIC32_FEATURE_SET__ <= 460
-			//if(((WORD*)vTickReading)[0] == 0xFFFFu)
-            if(wTemp.Val == 0xFFFFu)
-				dwTempTicks--;
-		#elif !defined(__PIC32_FEATURE_SET__)
-			#error __PIC32_FEATURE_SET__ macro must be defined.  You need to download a newer C32 compiler version.
-		#endif
-		
-		// Get high 4 bytes
-		vTickReading[2] = ((BYTE*)&dwTempTicks)[0];
-		vTickReading[3] = ((BYTE*)&dwTempTicks)[1];
-		vTickReading[4] = ((BYTE*)&dwTempTicks)[2];
-		vTickReading[5] = ((BYTE*)&dwTempTicks)[3];
-	} while(IFS0bits.T1IF);
-	IEC0SET = _IEC0_T1IE_MASK;		// Enable interrupt
 #endif
 }
+#endif
 
 
 /*****************************************************************************
@@ -269,6 +235,9 @@ static void GetTickCopy(void)
   ***************************************************************************/
 DWORD TickGet(void)
 {
+#if defined(__PIC32MX__)
+	return (DWORD)(TimerGetTicks64().value >> 8);
+#else
     DWORD dw;
     
 	GetTickCopy();
@@ -277,6 +246,7 @@ DWORD TickGet(void)
 	((BYTE*)&dw)[2] = vTickReading[2];	// memory reads, which will reset the PIC.
 	((BYTE*)&dw)[3] = vTickReading[3];
 	return dw;
+#endif
 }
 
 /*****************************************************************************
@@ -305,6 +275,9 @@ DWORD TickGet(void)
   ***************************************************************************/
 DWORD TickGetDiv256(void)
 {
+#if defined(__PIC32MX__)
+	return (DWORD)(TimerGetTicks64().value >> 16);
+#else
 	DWORD dw;
 
 	GetTickCopy();
@@ -314,6 +287,7 @@ DWORD TickGetDiv256(void)
 	((BYTE*)&dw)[3] = vTickReading[4];
 	
 	return dw;
+#endif
 }
 
 /*****************************************************************************
@@ -342,6 +316,9 @@ DWORD TickGetDiv256(void)
   ***************************************************************************/
 DWORD TickGetDiv64K(void)
 {
+#if defined(__PIC32MX__)
+	return (DWORD)(TimerGetTicks64().value >> 24);
+#else
 	DWORD dw;
 
 	GetTickCopy();
@@ -351,6 +328,7 @@ DWORD TickGetDiv64K(void)
 	((BYTE*)&dw)[3] = vTickReading[5];
 	
 	return dw;
+#endif
 }
 
 
@@ -432,16 +410,7 @@ void TickUpdate(void)
   Returns:
   	None
   ***************************************************************************/
-#elif defined(__PIC32MX__)
-void __attribute((interrupt(ipl2), vector(_TIMER_1_VECTOR), nomips16)) _T1Interrupt(void)
-{
-	// Increment internal high tick counter
-	dwInternalTicks++;
-
-	// Reset interrupt flag
-	IFS0CLR = _IFS0_T1IF_MASK;
-}
-#else
+#elif !defined(__PIC32MX__)
 #if __C30_VERSION__ >= 300
 void _ISR __attribute__((__no_auto_psv__)) _T1Interrupt(void)
 #else
@@ -815,6 +815,86 @@ WORD UDPPutArray(BYTE *cData, WORD wDataLen)
     return wDataLen;
 }
 
+/*****************************************************************************
+  Function:
+	BYTE* UDPGetTxPointer(WORD *wAvailable)
+
+  Summary:
+	Gets a pointer to the current write location in the TX buffer.
+	
+  Description:
+	This function returns a pointer directly into the MAC transmit buffer at
+	the current write location of the currently active socket.  This allows
+	the application to encode a payload in place rather than building it in
+	a separate buffer and copying it with UDPPutArray.  Once written, the
+	bytes must be committed with UDPPutDirect before the next UDPPut,
+	UDPPutArray, UDPPutString, or UDPFlush call.  UDPIsPutReady should be
+	used before calling this function to specify the currently active socket.
+
+  Precondition:
+	UDPIsPutReady() was previously called to specify the current socket.
+
+  Parameters:
+	wAvailable - Pointer to where the number of bytes that may be written
+		will be stored.
+	
+  Returns:
+  	Pointer to the current write location in the TX buffer.
+  	
+  Remarks:
+	This function is only available for the PIC32 internal MAC because the
+	TX buffer of other controllers is not directly addressable.
+  ***************************************************************************/
+#if defined(__PIC32MX__) && defined(_ETH) && !defined(ENC100_INTERFACE_MODE) && !defined(ENC_CS_TRIS) && !defined(WF_CS_TRIS)
+BYTE* UDPGetTxPointer(WORD *wAvailable)
+{
+	*wAvailable = (MAC_TX_BUFFER_SIZE - sizeof(IP_HEADER) - sizeof(UDP_HEADER)) - wPutOffset;
+
+	return (BYTE*)(BASE_TX_ADDR + sizeof(ETHER_HEADER) + sizeof(IP_HEADER) + sizeof(UDP_HEADER) + wPutOffset);
+}
+
+/*****************************************************************************
+  Function:
+	WORD UDPPutDirect(WORD wDataLen)
+
+  Summary:
+	Commits bytes written directly to the TX buffer.
+	
+  Description:
+	This function accounts for bytes that were written directly to the TX
+	buffer through the pointer returned by UDPGetTxPointer.  The buffer
+	length and write pointer are advanced exactly as if the bytes had been
+	written with UDPPutArray.
+
+  Precondition:
+	UDPGetTxPointer() was previously called and the bytes written.
+
+  Parameters:
+	wDataLen - Number of bytes written.
+	
+  Returns:
+  	The number of bytes committed.  If this value is less than wDataLen, 
+  	then the buffer became full and the input was truncated.
+  ***************************************************************************/
+WORD UDPPutDirect(WORD wDataLen)
+{
+	WORD wTemp;
+
+	wTemp = (MAC_TX_BUFFER_SIZE - sizeof(IP_HEADER) - sizeof(UDP_HEADER)) - wPutOffset;
+	if(wTemp < wDataLen)
+		wDataLen = wTemp;
+
+	wPutOffset += wDataLen;
+	if(wPutOffset > UDPTxCount)
+		UDPTxCount = wPutOffset;
+
+	// Advance the MAC write pointer past the bytes already in place
+	MACSetWritePtr(BASE_TX_ADDR + sizeof(ETHER_HEADER) + sizeof(IP_HEADER) + sizeof(UDP_HEADER) + wPutOffset);
+
+	return wDataLen;
+}
+#endif
+
 /*****************************************************************************
   Function:
 	WORD UDPPutROMArray(ROM BYTE *cData, WORD wDataLen)
@@ -1186,6 +1266,45 @@ void UDPDiscard(void)
 
 
 
+/*****************************************************************************
+  Function:
+	QWORD UDPGetRxTimestamp(void)
+
+  Summary:
+	Gets the time of arrival of the received UDP packet.
+	
+  Description:
+	This function returns the time of arrival of the packet held by the
+	currently active UDP socket.  The time is captured in the Ethernet RX
+	done interrupt and so is independent of the latency of StackTask.
+
+  Precondition:
+	UDPIsGetReady() was previously called to select the currently active
+	socket.  MACSetRxTimestampFunction() was previously called to enable RX
+	timestamping.
+
+  Parameters:
+	None
+	
+  Returns:
+  	The value returned by the timestamp function when the packet was
+  	received.  0 if no data is available or RX timestamping is disabled.
+
+  Remarks:
+	This function is only available for the PIC32 internal MAC.
+  ***************************************************************************/
+#if defined(__PIC32MX__) && defined(_ETH) && !defined(ENC100_INTERFACE_MODE) && !defined(ENC_CS_TRIS) && !defined(WF_CS_TRIS)
+QWORD UDPGetRxTimestamp(void)
+{
+	if(SocketWithRxData != activeUDPSocket)
+		return 0;
+
+	return MACGetRxTimestamp();
+}
+#endif
+
+
+
 /****************************************************************************
   Section:
 	Data Processing Functions
@@ -0,0 +1,499 @@
+/**
+ * @file Benchmark.c
+ * @author Seb Madgwick
+ * @brief Measures the execution time of Osc99 library functions on the target
+ * or on the host.
+ *
+ * Each benchmark executes a single operation on a realistic OSC message mix.
+ * The operation is repeated BENCHMARK_ITERATIONS times and the elapsed timer
+ * ticks are measured.  The measurement is repeated BENCHMARK_REPEATS times and
+ * the minimum is used so that the result is not inflated by interrupts.  The
+ * results are reported in ns/op and operations per second as a JSON string.
+ * A benchmark fails if it exceeds its regression threshold.  For the dispatch
+ * benchmarks, the operations per second are the OSC address lookups per second
+ * and scan_literal is the linear scan baseline.
+ *
+ * On the target, the JSON string is broadcast within the OSC message
+ * "/benchmark".  On the host, BENCHMARK_HOST is defined and the JSON string is
+ * printed by Tests/BenchmarkMain.c.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Benchmark.h"
+
+#ifdef BENCHMARK_ENABLED
+
+#ifndef BENCHMARK_HOST
+#include "Ethernet/Ethernet.h"
+#endif
+#include "Osc99/Osc99.h"
+#include <stdbool.h> // bool, true, false
+#include <stdint.h> // uint32_t, uint64_t
+#include <stdio.h> // snprintf
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of operations measured by each benchmark, and number of times
+ * each benchmark is repeated.  More operations are measured on the host so
+ * that the measurement is longer than the scheduling jitter of the host.
+ * These values may be modified as required by the user application.
+ */
+#ifdef BENCHMARK_HOST
+#define BENCHMARK_ITERATIONS 100000
+#define BENCHMARK_REPEATS 5
+#else
+#define BENCHMARK_ITERATIONS 1000
+#define BENCHMARK_REPEATS 3
+#endif
+
+/**
+ * @brief Regression threshold (ns/op) on the target or on the host.  The host
+ * thresholds are set well above the typical results of a desktop x86-64 CPU so
+ * that only a significant regression fails.
+ */
+#ifdef BENCHMARK_HOST
+#define THRESHOLD(targetNs, hostNs) (hostNs)
+#else
+#define THRESHOLD(targetNs, hostNs) (targetNs)
+#endif
+
+#ifndef BENCHMARK_HOST
+
+/**
+ * @brief Period (in seconds) at which the results are broadcast.
+ */
+#define BROADCAST_PERIOD 5
+
+#endif
+
+/**
+ * @brief Sensor OSC message type with capacity for the sensor OSC message
+ * arguments.
+ */
+OSC_MESSAGE_TYPE(SensorMessage, 8, 48);
+
+/**
+ * @brief Benchmark definition.  The threshold is the maximum ns/op before the
+ * benchmark is considered to have regressed, or 0 if there is no threshold.
+ * Thresholds may be modified as required by the user application.
+ */
+typedef struct {
+    const char* name;
+    int (*operation)();
+    uint32_t thresholdNs;
+} Benchmark;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static int MessageEncode();
+static int MessageWrite();
+static int MessageDecode();
+static int MessageViewDecode();
+static int BundleWalk();
+static int AddressMatchLiteral();
+static int AddressMatchWildcard();
+static int DispatchLiteral();
+static int DispatchWildcard();
+static int ScanLiteral();
+static void CountMatch(void* const context);
+static int SlipEncode();
+static int SlipDecode();
+static void ProcessPacket(OscPacket * const oscPacket);
+static void CreateSources();
+static Ticks32 Measure(int (*operation)());
+static int CreateResults();
+
+//------------------------------------------------------------------------------
+// Variables
+
+static const Benchmark benchmarks[] = {
+    { "message_encode", MessageEncode, THRESHOLD(60000, 2500)},
+    { "message_write", MessageWrite, THRESHOLD(30000, 1000)},
+    { "message_decode", MessageDecode, THRESHOLD(60000, 2500)},
+    { "message_view_decode", MessageViewDecode, THRESHOLD(30000, 1500)},
+    { "bundle_walk", BundleWalk, THRESHOLD(30000, 2500)},
+    { "address_match_literal", AddressMatchLiteral, THRESHOLD(5000, 500)},
+    { "address_match_wildcard", AddressMatchWildcard, THRESHOLD(30000, 3000)},
+    { "dispatch_literal", DispatchLiteral, THRESHOLD(20000, 500)},
+    { "dispatch_wildcard", DispatchWildcard, THRESHOLD(150000, 5000)},
+    { "scan_literal", ScanLiteral, THRESHOLD(60000, 2000)},
+    { "slip_encode", SlipEncode, THRESHOLD(20000, 2500)},
+    { "slip_decode", SlipDecode, THRESHOLD(20000, 2500)},
+};
+#define NUMBER_OF_BENCHMARKS (sizeof (benchmarks) / sizeof (Benchmark))
+
+static Ticks32 benchmarkTicks[NUMBER_OF_BENCHMARKS];
+static SensorMessage sensorMessage;
+static OscMessage oscMessage;
+static char sensorMessageContents[128];
+static size_t sensorMessageSize;
+static char bundleContents[256];
+static size_t bundleSize;
+static OscPacket bundlePacket;
+static char slipPacket[2 * sizeof (bundleContents)];
+static size_t slipPacketSize;
+static OscSlipDecoder oscSlipDecoder;
+static int numberOfPacketsDecoded;
+static const char* const methodAddresses[] = {
+    "/sync", "/sync_rate", "/sync_burst", "/delay_req", "/subscribe", "/unsubscribe", "/external", "/sensor/imu/gyroscope",
+    "/sensor/imu/accelerometer", "/sensor/imu/magnetometer", "/sensor/temperature", "/sensor/pressure", "/inputs/digital", "/inputs/analogue", "/outputs/digital", "/outputs/pwm",
+};
+static OscAddressDispatcher oscAddressDispatcher;
+static int numberOfMatches;
+static char json[1440]; // results OSC message must fit in one UDP packet
+#ifndef BENCHMARK_HOST
+static char results[sizeof (json) + 16]; // OSC message containing JSON string
+static size_t resultsSize;
+#endif
+
+//------------------------------------------------------------------------------
+// Functions
+
+#ifndef BENCHMARK_HOST
+
+/**
+ * @brief Initialises module and runs the benchmarks.  This function should be
+ * called once on system start up.
+ */
+void BenchmarkInitialise() {
+    BenchmarkRun();
+    OscMessageWriter oscMessageWriter;
+    OscMessageWriterInitialise(&oscMessageWriter, results, sizeof (results), "/benchmark", ",s");
+    OscMessageWriterAddString(&oscMessageWriter, json);
+    OscMessageWriterFinalise(&oscMessageWriter, &resultsSize);
+}
+
+/**
+ * @brief Do tasks.  This function should be called repeatedly within the main
+ * program loop.
+ */
+void BenchmarkDoTasks() {
+    static Ticks32 previousTicks;
+    const Ticks32 currentTicks = TimerGetTicks32();
+    if ((currentTicks - previousTicks) >= (TIMER_TICKS_PER_SECOND * BROADCAST_PERIOD)) {
+        previousTicks = currentTicks;
+        EthernetBroadcast(results, resultsSize);
+    }
+}
+
+#endif
+
+/**
+ * @brief Runs each benchmark and updates the results.  Blocks for the duration
+ * of the benchmarks.
+ * @return 0 if no benchmark failed or exceeded its regression threshold.
+ */
+int BenchmarkRun() {
+    CreateSources();
+    int index;
+    for (index = 0; index < NUMBER_OF_BENCHMARKS; index++) {
+        benchmarkTicks[index] = Measure(benchmarks[index].operation);
+    }
+    return CreateResults();
+}
+
+/**
+ * @brief Gets the results of the most recent call to BenchmarkRun.
+ * @return Results as a JSON string.
+ */
+const char* BenchmarkGetResults() {
+    return json;
+}
+
+/**
+ * @brief Constructs the sensor OSC message and serialises it.
+ * @return 0 if successful.
+ */
+static int MessageEncode() {
+    if (OSC_MESSAGE_INITIALISE(&sensorMessage, "/sensor/imu") != 0) {
+        return 1;
+    }
+    OscMessageAddFloat32(OSC_MESSAGE(&sensorMessage), 0.1f);
+    OscMessageAddFloat32(OSC_MESSAGE(&sensorMessage), -0.2f);
+    OscMessageAddFloat32(OSC_MESSAGE(&sensorMessage), 0.3f);
+    OscMessageAddFloat32(OSC_MESSAGE(&sensorMessage), 0.0f);
+    OscMessageAddFloat32(OSC_MESSAGE(&sensorMessage), 0.0f);
+    OscMessageAddFloat32(OSC_MESSAGE(&sensorMessage), 1.0f);
+    OscMessageAddInt32(OSC_MESSAGE(&sensorMessage), 1234);
+    OscMessageAddString(OSC_MESSAGE(&sensorMessage), "ok");
+    return OscMessageToCharArray(OSC_MESSAGE(&sensorMessage), &sensorMessageSize, sensorMessageContents, sizeof (sensorMessageContents));
+}
+
+/**
+ * @brief Writes the sensor OSC message in place.
+ * @return 0 if successful.
+ */
+static int MessageWrite() {
+    OscMessageWriter oscMessageWriter;
+    if (OscMessageWriterInitialise(&oscMessageWriter, sensorMessageContents, sizeof (sensorMessageContents), "/sensor/imu", ",ffffffis") != 0) {
+        return 1;
+    }
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.1f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, -0.2f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.3f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.0f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.0f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 1.0f);
+    OscMessageWriterAddInt32(&oscMessageWriter, 1234);
+    OscMessageWriterAddString(&oscMessageWriter, "ok");
+    return OscMessageWriterFinalise(&oscMessageWriter, &sensorMessageSize);
+}
+
+/**
+ * @brief Parses the sensor OSC message as OscPacketProcessMessages does and
+ * gets each argument.
+ * @return 0 if successful.
+ */
+static int MessageDecode() {
+    OscMessageInitialise(&oscMessage, "");
+    if (OscMessageInitialiseFromCharArray(&oscMessage, sensorMessageContents, sensorMessageSize) != 0) {
+        return 1;
+    }
+    float float32;
+    int32_t int32;
+    char string[8];
+    int error = 0;
+    while (OscMessageGetArgumentType(&oscMessage) == OscTypeTagFloat32) {
+        error |= OscMessageGetFloat32(&oscMessage, &float32);
+    }
+    error |= OscMessageGetInt32(&oscMessage, &int32);
+    error |= OscMessageGetString(&oscMessage, string, sizeof (string));
+    return error;
+}
+
+/**
+ * @brief Parses the sensor OSC message in place using an OSC message view and
+ * gets each argument.
+ * @return 0 if successful.
+ */
+static int MessageViewDecode() {
+    OscMessageView oscMessageView;
+    if (OscMessageViewInitialise(&oscMessageView, sensorMessageContents, sensorMessageSize) != 0) {
+        return 1;
+    }
+    float float32;
+    int32_t int32;
+    const char* string;
+    size_t stringLength;
+    int error = 0;
+    while (OscMessageViewGetArgumentType(&oscMessageView) == OscTypeTagFloat32) {
+        error |= OscMessageViewGetFloat32(&oscMessageView, &float32);
+    }
+    error |= OscMessageViewGetInt32(&oscMessageView, &int32);
+    error |= OscMessageViewGetString(&oscMessageView, &string, &stringLength);
+    return error;
+}
+
+/**
+ * @brief Iterates through each OSC message within the OSC bundle.
+ * @return 0 if successful.
+ */
+static int BundleWalk() {
+    OscPacketIterator oscPacketIterator;
+    OscPacketIteratorInitialise(&oscPacketIterator, bundleContents, bundleSize);
+    const OscTimeTag* oscTimeTag;
+    OscMessageView oscMessageView;
+    int numberOfMessages = 0;
+    while (OscPacketNextMessage(&oscPacketIterator, &oscTimeTag, &oscMessageView) == 0) {
+        numberOfMessages++;
+    }
+    return numberOfMessages == 4 ? 0 : 1;
+}
+
+/**
+ * @brief Matches a literal OSC address pattern.
+ * @return 0 if successful.
+ */
+static int AddressMatchLiteral() {
+    return OscAddressMatch("/sensor/imu/gyroscope", "/sensor/imu/gyroscope") == true ? 0 : 1;
+}
+
+/**
+ * @brief Matches an OSC address pattern containing each type of wildcard.
+ * @return 0 if successful.
+ */
+static int AddressMatchWildcard() {
+    return OscAddressMatch("/sensor/{imu,mag}/*scop?/[a-z]*", "/sensor/imu/gyroscope/x") == true ? 0 : 1;
+}
+
+/**
+ * @brief Dispatches a literal OSC address to the OSC address dispatcher.  The
+ * ops/s is the number of lookups per second.
+ * @return 0 if successful.
+ */
+static int DispatchLiteral() {
+    numberOfMatches = 0;
+    OscAddressDispatcherDispatch(&oscAddressDispatcher, "/sensor/imu/magnetometer", &numberOfMatches);
+    return numberOfMatches == 1 ? 0 : 1;
+}
+
+/**
+ * @brief Dispatches an OSC address pattern containing a wildcard to the OSC
+ * address dispatcher.
+ * @return 0 if successful.
+ */
+static int DispatchWildcard() {
+    numberOfMatches = 0;
+    OscAddressDispatcherDispatch(&oscAddressDispatcher, "/sensor/imu/*", &numberOfMatches);
+    return numberOfMatches == 3 ? 0 : 1;
+}
+
+/**
+ * @brief Matches a literal OSC address with each method OSC address using
+ * OscAddressMatch.  This is the linear scan replaced by the OSC address
+ * dispatcher and so is the baseline for DispatchLiteral.
+ * @return 0 if successful.
+ */
+static int ScanLiteral() {
+    numberOfMatches = 0;
+    int index;
+    for (index = 0; index < (sizeof (methodAddresses) / sizeof (methodAddresses[0])); index++) {
+        if (OscAddressMatch("/sensor/imu/magnetometer", methodAddresses[index]) == true) {
+            CountMatch(&numberOfMatches);
+        }
+    }
+    return numberOfMatches == 1 ? 0 : 1;
+}
+
+/**
+ * @brief Counts each method matched.
+ * @param context Address of the number of matches.
+ */
+static void CountMatch(void* const context) {
+    (*(int*) context)++;
+}
+
+/**
+ * @brief Encodes the OSC bundle as a SLIP packet.
+ * @return 0 if successful.
+ */
+static int SlipEncode() {
+    return OscSlipEncodePacket(&bundlePacket, &slipPacketSize, slipPacket, sizeof (slipPacket));
+}
+
+/**
+ * @brief Decodes the SLIP packet.
+ * @return 0 if successful.
+ */
+static int SlipDecode() {
+    numberOfPacketsDecoded = 0;
+    OscSlipDecoderProcessBytes(&oscSlipDecoder, slipPacket, slipPacketSize);
+    return numberOfPacketsDecoded == 1 ? 0 : 1;
+}
+
+/**
+ * @brief Counts each OSC packet decoded by the OSC SLIP decoder.
+ * @param oscPacket Address of the decoded OSC packet.
+ */
+static void ProcessPacket(OscPacket * const oscPacket) {
+    numberOfPacketsDecoded++;
+}
+
+/**
+ * @brief Creates the sensor OSC message, the OSC bundle, the SLIP packet and
+ * the OSC address dispatcher used as the source of each benchmark.  The OSC
+ * bundle contains the synchronisation and external clock OSC messages, the
+ * sensor OSC message and a nested OSC bundle.  The time tag contains bytes that
+ * require SLIP escaping.  The OSC address dispatcher contains one method for
+ * each of the firmware and typical sensor OSC addresses.
+ */
+static void CreateSources() {
+    MessageEncode();
+    const OscTimeTag oscTimeTag = {.dwordStruct.seconds = 0xC0DBC0DB, .dwordStruct.fraction = 0x12345678};
+    OscBundleWriter oscBundleWriter;
+    OscBundleWriterInitialise(&oscBundleWriter, bundleContents, sizeof (bundleContents), oscTimeTag);
+    OscMessageWriter oscMessageWriter;
+    OscBundleWriterOpenMessage(&oscBundleWriter, &oscMessageWriter, "/sync", ",t");
+    OscMessageWriterAddTimeTag(&oscMessageWriter, oscTimeTag);
+    OscBundleWriterCloseMessage(&oscBundleWriter, &oscMessageWriter);
+    OscBundleWriterOpenMessage(&oscBundleWriter, &oscMessageWriter, "/external", ",T");
+    OscBundleWriterCloseMessage(&oscBundleWriter, &oscMessageWriter);
+    OscBundleWriterOpenMessage(&oscBundleWriter, &oscMessageWriter, "/sensor/imu", ",ffffffis");
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.1f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, -0.2f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.3f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.0f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 0.0f);
+    OscMessageWriterAddFloat32(&oscMessageWriter, 1.0f);
+    OscMessageWriterAddInt32(&oscMessageWriter, 1234);
+    OscMessageWriterAddString(&oscMessageWriter, "ok");
+    OscBundleWriterCloseMessage(&oscBundleWriter, &oscMessageWriter);
+    OscBundleWriterOpenBundle(&oscBundleWriter, oscTimeTag);
+    OscBundleWriterOpenMessage(&oscBundleWriter, &oscMessageWriter, "/sensor/temperature", ",f");
+    OscMessageWriterAddFloat32(&oscMessageWriter, 25.0f);
+    OscBundleWriterCloseMessage(&oscBundleWriter, &oscMessageWriter);
+    OscBundleWriterCloseBundle(&oscBundleWriter);
+    OscBundleWriterFinalise(&oscBundleWriter, &bundleSize);
+    OscPacketInitialise(&bundlePacket);
+    OscPacketInitialiseFromCharArray(&bundlePacket, bundleContents, bundleSize);
+    SlipEncode();
+    OscSlipDecoderInitialise(&oscSlipDecoder);
+    oscSlipDecoder.processPacket = ProcessPacket;
+    OscAddressDispatcherInitialise(&oscAddressDispatcher);
+    int index;
+    for (index = 0; index < (sizeof (methodAddresses) / sizeof (methodAddresses[0])); index++) {
+        OscAddressDispatcherAddMethod(&oscAddressDispatcher, methodAddresses[index], CountMatch);
+    }
+}
+
+/**
+ * @brief Measures the execution time of BENCHMARK_ITERATIONS operations.
+ * @param operation Operation to be measured.
+ * @return Minimum timer ticks of each repeat, or 0 if the operation failed.
+ */
+static Ticks32 Measure(int (*operation)()) {
+    Ticks32 minimumTicks = UINT32_MAX;
+    int repeat;
+    for (repeat = 0; repeat < BENCHMARK_REPEATS; repeat++) {
+        int error = 0;
+        const Ticks32 startTicks = TimerGetTicks32();
+        int iteration;
+        for (iteration = 0; iteration < BENCHMARK_ITERATIONS; iteration++) {
+            error |= operation();
+        }
+        const Ticks32 ticks = TimerGetTicks32() - startTicks;
+        if (error != 0) {
+            return 0;
+        }
+        if (ticks < minimumTicks) {
+            minimumTicks = ticks;
+        }
+    }
+    return minimumTicks;
+}
+
+/**
+ * @brief Creates the results as a JSON string.
+ * @return 0 if no benchmark failed or exceeded its regression threshold.
+ */
+static int CreateResults() {
+    size_t jsonLength = snprintf(json, sizeof (json), "{\"iterations\":%u,\"benchmarks\":[", BENCHMARK_ITERATIONS);
+    bool pass = true;
+    int index;
+    for (index = 0; index < NUMBER_OF_BENCHMARKS; index++) {
+        const uint64_t ticks = benchmarkTicks[index];
+        const uint32_t nsPerOp = ticks == 0 ? 0 : (ticks * 1000000000ull) / ((uint64_t) TIMER_TICKS_PER_SECOND * BENCHMARK_ITERATIONS);
+        const uint32_t opsPerSecond = ticks == 0 ? 0 : ((uint64_t) TIMER_TICKS_PER_SECOND * BENCHMARK_ITERATIONS) / ticks;
+        const bool benchmarkPass = (ticks != 0) && ((benchmarks[index].thresholdNs == 0) || (nsPerOp <= benchmarks[index].thresholdNs));
+        pass &= benchmarkPass;
+        if (jsonLength < sizeof (json)) {
+            jsonLength += snprintf(&json[jsonLength], sizeof (json) - jsonLength, "%s{\"name\":\"%s\",\"ns_per_op\":%lu,\"ops_per_s\":%lu,\"threshold_ns\":%lu,\"pass\":%s}",
+                    index == 0 ? "" : ",", benchmarks[index].name, (unsigned long) nsPerOp, (unsigned long) opsPerSecond, (unsigned long) benchmarks[index].thresholdNs, benchmarkPass ? "true" : "false");
+        }
+    }
+    if (jsonLength < sizeof (json)) {
+        snprintf(&json[jsonLength], sizeof (json) - jsonLength, "],\"pass\":%s}", pass ? "true" : "false");
+    }
+    return pass ? 0 : 1;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
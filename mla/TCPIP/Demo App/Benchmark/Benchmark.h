@@ -0,0 +1,36 @@
+/**
+ * @file Benchmark.h
+ * @author Seb Madgwick
+ * @brief Measures the execution time of Osc99 library functions on the target
+ * or on the host.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Uncomment to run the benchmarks on system start up and broadcast the
+ * results.  This should only be enabled for development as the benchmarks
+ * delay start up and the results are broadcast periodically.
+ *
+ * The host build in Tests/Makefile defines BENCHMARK_ENABLED and
+ * BENCHMARK_HOST so that the benchmarks are run natively without the Ethernet
+ * module.
+ */
+//#define BENCHMARK_ENABLED
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void BenchmarkInitialise();
+void BenchmarkDoTasks();
+int BenchmarkRun();
+const char* BenchmarkGetResults();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -9,16 +9,44 @@
 
 #include "Ethernet/Ethernet.h"
 #include "InitAppConfig.h"
+#include <string.h> // memcpy
 #include "TCPIP Stack/TCPIP.h"
+#include "Timer/Timer.h"
 
 //------------------------------------------------------------------------------
 // Definitions
 
+/**
+ * @brief IP address and port to which EthernetUnicast sends packets.  External
+ * clock edge timestamps are sent here while there are no subscribers.  These
+ * values may be modified as required by the user application.
+ */
 #define UNICAST_IP "192.168.1.2"
 #define UNICAST_PORT 8000
+
 #define BROADCAST_PORT 9000
 #define RECEIVE_PORT 9000
 
+/**
+ * @brief Uncomment to send broadcast messages to an IP multicast group rather
+ * than the IP broadcast address.  Only hosts that have joined the group then
+ * receive synchronisation messages, and Wi-Fi access points may forward them
+ * at a higher rate than broadcasts.  The group is joined using IGMP so that
+ * IGMP snooping switches also forward messages sent to the group by slaves.
+ * The group address may be modified as required by the user application.
+ * STACK_USE_IGMP must also be defined in TCPIPConfig.h.
+ */
+//#define MULTICAST_IP "239.255.0.1"
+
+#if defined(MULTICAST_IP) && !defined(STACK_USE_IGMP)
+#error "STACK_USE_IGMP must be defined in TCPIPConfig.h when MULTICAST_IP is defined"
+#endif
+
+/**
+ * @brief Maximum size of UDP packet that fits in a single Ethernet frame.
+ */
+#define MAX_UDP_PACKET_SIZE (1500 - sizeof (IP_HEADER) - sizeof (UDP_HEADER))
+
 //------------------------------------------------------------------------------
 // Variables
 
@@ -26,6 +54,20 @@ static UDP_SOCKET unicastSocket = INVALID_UDP_SOCKET;
 static UDP_SOCKET broadcastSocket = INVALID_UDP_SOCKET;
 static UDP_SOCKET receiveSocket = INVALID_UDP_SOCKET;
 static IP_ADDR unicastIP;
+static EthernetEndpoint lastSender;
+#ifdef MULTICAST_IP
+static NODE_INFO multicastNode;
+#endif
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void DoStackTasks();
+static QWORD GetTimestamp();
+static int SendToEndpoint(const EthernetEndpoint * const endpoint, const WORD sum, const char* const source, const size_t numberOfBytes);
+static WORD GetSum(const BYTE* const bytes, const size_t numberOfBytes);
+static WORD UpdateChecksum(const WORD checksum, const BYTE* const oldBytes, const BYTE* const newBytes, const size_t numberOfBytes);
+static int GetBuffer(const UDP_SOCKET socket, char* * const destination, size_t * const destinationSize);
 
 //------------------------------------------------------------------------------
 // Functions
@@ -40,9 +82,18 @@ void EthernetInitialise() {
     TickInit();
     InitAppConfig();
     StackInit();
+    MACSetRxTimestampFunction(GetTimestamp);
+    MACSetTxTimestampFunction(GetTimestamp);
     
     // Parse IP address from string
     StringToIPAddress((BYTE*) UNICAST_IP, &unicastIP);
+
+    // Join multicast group
+#ifdef MULTICAST_IP
+    StringToIPAddress((BYTE*) MULTICAST_IP, &multicastNode.IPAddr);
+    IGMPGetGroupMACAddr(multicastNode.IPAddr, &multicastNode.MACAddr); // socket is opened with the group MAC address as ARP cannot resolve a multicast address
+    IGMPJoinGroup(multicastNode.IPAddr);
+#endif
 }
 
 /**
@@ -52,8 +103,7 @@ void EthernetInitialise() {
 void EthernetDoTasks() {
     
     // Perform TCP/IP stack tasks and applications
-    StackTask();
-    StackApplications();        
+    DoStackTasks();
 
     // Maintain UDP sockets
     if (MACIsLinked()) {
@@ -69,11 +119,21 @@ void EthernetDoTasks() {
 
         // Open broadcast socket
         if (broadcastSocket == INVALID_UDP_SOCKET) {
+#ifdef MULTICAST_IP
+            broadcastSocket = UDPOpenEx((DWORD) (PTR_BASE) &multicastNode, UDP_OPEN_NODE_INFO, RECEIVE_PORT, BROADCAST_PORT);
+#else
             broadcastSocket = UDPOpenEx((DWORD) NULL, UDP_OPEN_NODE_INFO, RECEIVE_PORT, BROADCAST_PORT);
+#endif
         }
         
-        // Open receive socket
-        if (receiveSocket == INVALID_UDP_SOCKET) {
+        // Open receive socket last so that it receives all packets not matched to the unicast or broadcast socket.
+        // The unicast and broadcast sockets use RECEIVE_PORT as their local port so that replies to their packets
+        // are sent to RECEIVE_PORT.  FindMatchingSocket gives a packet to the socket whose remote IP address and
+        // port match the sender, else to the socket with the highest index whose local port matches.  UDPOpenEx
+        // allocates the lowest free index and so the receive socket must be opened after the other two, and all
+        // three closed together, for it to have the highest index.  A packet sent from UNICAST_IP and UNICAST_PORT
+        // is matched to the unicast socket and so is not received.
+        if ((receiveSocket == INVALID_UDP_SOCKET) && (unicastSocket != INVALID_UDP_SOCKET) && (broadcastSocket != INVALID_UDP_SOCKET)) {
             receiveSocket = UDPOpenEx(0, UDP_OPEN_SERVER, RECEIVE_PORT, 0);
         }        
 
@@ -87,6 +147,14 @@ void EthernetDoTasks() {
     }
 }
 
+/**
+ * @brief Returns true if the Ethernet link is up.
+ * @return true if the Ethernet link is up.
+ */
+bool EthernetIsLinked() {
+    return MACIsLinked() ? true : false;
+}
+
 /**
  * @brief Unicasts UDP packet.
  * @param source Address of packet.
@@ -106,7 +174,8 @@ int EthernetUnicast(const char* const source, const size_t numberOfBytes) {
 }
 
 /**
- * @brief Broadcasts UDP packet.
+ * @brief Broadcasts UDP packet.  The packet is sent to the multicast group if
+ * MULTICAST_IP is defined.
  * @param source Address of packet.
  * @param numberOfBytes Size of packet.
  * @return 0 if successful.
@@ -124,15 +193,355 @@ int EthernetBroadcast(const char* const source, const size_t numberOfBytes) {
 }
 
 /**
- * @brief Gets UDP packet from receive buffer.
+ * @brief Sends the same UDP packet to each endpoint until a transmit buffer is
+ * not available.
+ *
+ * The ones' complement sum of the packet is calculated once.  Only the IP
+ * header, UDP header and UDP checksum are then calculated for each endpoint so
+ * that each additional endpoint costs little more than copying the packet to a
+ * transmit buffer.  This function does not wait for a transmit buffer to
+ * become available.  The caller should instead call this function again later
+ * for the endpoints to which the packet was not sent.
+ *
+ * @param endpoints Address of endpoints.
+ * @param numberOfEndpoints Number of endpoints.
+ * @param source Address of packet.
+ * @param numberOfBytes Size of packet.
+ * @param numberOfEndpointsSent Address where the number of endpoints to which
+ * the packet was sent will be written.  The packet is sent to the endpoints in
+ * order.
+ * @return 0 if successful.  An error is returned if the packet could not be
+ * sent to all of the endpoints.
+ */
+int EthernetUnicastToEach(const EthernetEndpoint * const endpoints, const size_t numberOfEndpoints, const char* const source, const size_t numberOfBytes, size_t * const numberOfEndpointsSent) {
+    *numberOfEndpointsSent = 0;
+    if (!MACIsLinked()) {
+        return 1; // error: no link
+    }
+    if (numberOfBytes > MAX_UDP_PACKET_SIZE) {
+        return 1; // error: packet too large
+    }
+    const WORD sum = GetSum((const BYTE*) source, numberOfBytes);
+    while (*numberOfEndpointsSent < numberOfEndpoints) {
+        if (SendToEndpoint(&endpoints[*numberOfEndpointsSent], sum, source, numberOfBytes) != 0) {
+            return 1; // error: transmit buffer not available
+        }
+        (*numberOfEndpointsSent)++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Modifies and sends the packet prepared by EthernetPrepareBuffer.
+ *
+ * Bytes of the packet starting at the index are replaced and the UDP checksum
+ * is updated incrementally before the frame is handed to the MAC.  The stack
+ * is not used and so this function may be called from an interrupt.
+ *
+ * @param index Index within the packet of the first byte to be replaced.
+ * Must be even.
+ * @param source Address of replacement bytes.
+ * @param numberOfBytes Number of replacement bytes.  Must be even.
+ * @return 0 if successful.
+ */
+int EthernetBroadcastPrepared(const size_t index, const char* const source, const size_t numberOfBytes) {
+    WORD frameSize;
+    BYTE* const frame = MACGetDeferredTxBuffer(&frameSize);
+    if (frame == NULL) {
+        return 1; // error: no packet prepared
+    }
+    BYTE* const udpHeader = &frame[sizeof (ETHER_HEADER) + sizeof (IP_HEADER)];
+    BYTE* const destination = &udpHeader[sizeof (UDP_HEADER) + index];
+    if ((destination + numberOfBytes) > (frame + frameSize)) {
+        return 1; // error: bytes outside of packet
+    }
+    UDP_HEADER udpHeaderCopy;
+    memcpy(&udpHeaderCopy, udpHeader, sizeof (UDP_HEADER));
+    udpHeaderCopy.Checksum = UpdateChecksum(udpHeaderCopy.Checksum, destination, (const BYTE*) source, numberOfBytes);
+    memcpy(destination, source, numberOfBytes);
+    memcpy(udpHeader, &udpHeaderCopy, sizeof (UDP_HEADER));
+    MACTransmitDeferred();
+    return 0;
+}
+
+/**
+ * @brief Gets the transmit buffer of the unicast socket so that a packet may be
+ * written in place.  The packet is sent by EthernetSendBuffer.
+ * @param destination Address where the transmit buffer address will be
+ * written.
+ * @param destinationSize Address where the size of the transmit buffer will
+ * be written.
+ * @return 0 if successful.
+ */
+int EthernetGetUnicastBuffer(char* * const destination, size_t * const destinationSize) {
+    return GetBuffer(unicastSocket, destination, destinationSize);
+}
+
+/**
+ * @brief Gets the transmit buffer of the broadcast socket so that a packet may
+ * be written in place.  The packet is sent by EthernetSendBuffer.
+ * @param destination Address where the transmit buffer address will be
+ * written.
+ * @param destinationSize Address where the size of the transmit buffer will
+ * be written.
+ * @return 0 if successful.
+ */
+int EthernetGetBroadcastBuffer(char* * const destination, size_t * const destinationSize) {
+    return GetBuffer(broadcastSocket, destination, destinationSize);
+}
+
+/**
+ * @brief Sends the packet written in place to the transmit buffer obtained by
+ * EthernetGetUnicastBuffer or EthernetGetBroadcastBuffer.
+ * @param numberOfBytes Size of packet.
+ * @return 0 if successful.
+ */
+int EthernetSendBuffer(const size_t numberOfBytes) {
+    if (UDPPutDirect(numberOfBytes) < numberOfBytes) {
+        return 1; // error: too many bytes for transmit buffer
+    }
+    UDPFlush();
+    return 0;
+}
+
+/**
+ * @brief Prepares the packet written in place to the transmit buffer obtained
+ * by EthernetGetBroadcastBuffer to be broadcast by EthernetBroadcastPrepared.
+ *
+ * The complete frame, including all headers and the UDP checksum, is built
+ * and held by the MAC so that it may later be sent from an interrupt with
+ * minimal latency.  Only one packet may be prepared at a time.
+ *
+ * @param numberOfBytes Size of packet.
+ * @return 0 if successful.
+ */
+int EthernetPrepareBuffer(const size_t numberOfBytes) {
+    WORD frameSize;
+    if (MACGetDeferredTxBuffer(&frameSize) != NULL) {
+        return 1; // error: previous prepared packet not yet sent
+    }
+    if (UDPPutDirect(numberOfBytes) < numberOfBytes) {
+        return 1; // error: too many bytes for transmit buffer
+    }
+    MACDeferNextFlush();
+    UDPFlush();
+    return 0;
+}
+
+/**
+ * @brief Gets the time of transmission of the packet most recently sent by
+ * EthernetBroadcastPrepared.  This function does not wait and so should be
+ * called again if the packet has not yet been transmitted.
+ *
+ * The time of transmission is captured by the Ethernet TX done interrupt when
+ * the MAC completes transmission of the packet and so does not include the
+ * software latency of building and sending the packet.  The time is that of
+ * the end of the packet and so is later than the start of the packet by a
+ * constant for packets of a fixed size and link speed.
+ *
+ * @param transmitTime Address where the time of transmission will be written.
+ * @return 0 if successful.
+ */
+int EthernetGetTransmitTime(Ticks64 * const transmitTime) {
+    const QWORD timestamp = MACGetDeferredTxTimestamp();
+    if (timestamp == 0) {
+        return 1; // error: packet not yet transmitted
+    }
+    transmitTime->value = timestamp;
+    return 0;
+}
+
+/**
+ * @brief Gets UDP packet received by the receive socket.
+ *
+ * The TCP/IP stack holds only one received packet at a time.  If the current
+ * packet has already been read, or is not for the receive socket, then the
+ * stack tasks are performed to fetch the next packet from the MAC receive
+ * buffers.  This function may therefore be called repeatedly to service a
+ * burst of packets within a single iteration of the main program loop.  The
+ * sender of each packet must be obtained by EthernetGetSender before this
+ * function is called again.
+ *
+ * The time of arrival is captured by the Ethernet RX done interrupt and so is
+ * independent of the main program loop latency.  A packet larger than the
+ * destination is truncated.
+ *
  * @param destination Destination address.
  * @param destinationSize Size of destination that must not be exceeded.
+ * @param timeOfArrival Address where the time of arrival of the UDP packet
+ * will be written.
  * @return Size of UDP packet.  0 if receive buffer empty.
  */
-size_t EthernetGet(const char* const destination, const size_t destinationSize) {
-    if (UDPIsGetReady(receiveSocket) > 0) {
-        return UDPGetArray((BYTE*) destination, destinationSize);
+size_t EthernetGet(char* const destination, const size_t destinationSize, Ticks64 * const timeOfArrival) {
+    if (receiveSocket == INVALID_UDP_SOCKET) {
+        return 0; // error: socket not open
+    }
+    if (UDPIsGetReady(receiveSocket) == 0) {
+        DoStackTasks();
+        if (UDPIsGetReady(receiveSocket) == 0) {
+            return 0;
+        }
+    }
+    timeOfArrival->value = UDPGetRxTimestamp();
+    const UDP_SOCKET_INFO * const socketInfo = &UDPSocketInfo[receiveSocket];
+    memcpy(lastSender.macAddress, &socketInfo->remote.remoteNode.MACAddr, sizeof (lastSender.macAddress));
+    memcpy(lastSender.ipAddress, &socketInfo->remote.remoteNode.IPAddr, sizeof (lastSender.ipAddress));
+    lastSender.port = socketInfo->remotePort;
+    const size_t size = UDPGetArray((BYTE*) destination, destinationSize);
+    UDPDiscard(); // discard remainder of truncated packet
+    return size;
+}
+
+/**
+ * @brief Gets the sender of the packet most recently obtained by EthernetGet.
+ * @param sender Address where the sender will be written.
+ */
+void EthernetGetSender(EthernetEndpoint * const sender) {
+    *sender = lastSender;
+}
+
+/**
+ * @brief Performs the TCP/IP stack tasks and applications.
+ */
+static void DoStackTasks() {
+    StackTask();
+    StackApplications();
+}
+
+/**
+ * @brief Sends UDP packet to an endpoint.  The UDP checksum is calculated from
+ * the IP pseudo header and UDP header, and the sum of the packet.
+ * @param endpoint Address of endpoint.
+ * @param sum Ones' complement sum of the packet.
+ * @param source Address of packet.
+ * @param numberOfBytes Size of packet.
+ * @return 0 if successful.
+ */
+static int SendToEndpoint(const EthernetEndpoint * const endpoint, const WORD sum, const char* const source, const size_t numberOfBytes) {
+    if (MACIsTxReady() == FALSE) {
+        return 1; // error: transmit buffer not available
+    }
+    NODE_INFO remoteNode;
+    memcpy(&remoteNode.MACAddr, endpoint->macAddress, sizeof (remoteNode.MACAddr));
+    memcpy(&remoteNode.IPAddr, endpoint->ipAddress, sizeof (remoteNode.IPAddr));
+    const WORD udpLength = sizeof (UDP_HEADER) + numberOfBytes;
+
+    // Calculate UDP checksum
+    PSEUDO_HEADER pseudoHeader;
+    pseudoHeader.SourceAddress = AppConfig.MyIPAddr;
+    pseudoHeader.DestAddress = remoteNode.IPAddr;
+    pseudoHeader.Zero = 0;
+    pseudoHeader.Protocol = IP_PROT_UDP;
+    pseudoHeader.Length = udpLength;
+    SwapPseudoHeader(pseudoHeader);
+    UDP_HEADER udpHeader;
+    udpHeader.SourcePort = swaps(RECEIVE_PORT);
+    udpHeader.DestinationPort = swaps(endpoint->port);
+    udpHeader.Length = swaps(udpLength);
+    udpHeader.Checksum = ~CalcIPChecksum((BYTE*) &pseudoHeader, sizeof (pseudoHeader));
+    WORD sums[2];
+    sums[0] = ~CalcIPChecksum((BYTE*) &udpHeader, sizeof (udpHeader));
+    sums[1] = sum;
+    udpHeader.Checksum = CalcIPChecksum((BYTE*) sums, sizeof (sums));
+    if (udpHeader.Checksum == 0x0000) {
+        udpHeader.Checksum = 0xFFFF; // 0 indicates checksum not used
+    }
+
+    // Write and send packet
+    MACSetWritePtr(BASE_TX_ADDR + sizeof (ETHER_HEADER));
+    IPPutHeader(&remoteNode, IP_PROT_UDP, udpLength);
+    MACPutArray((BYTE*) &udpHeader, sizeof (udpHeader));
+    MACPutArray((BYTE*) source, numberOfBytes);
+    MACFlush();
+    return 0;
+}
+
+/**
+ * @brief Returns the ones' complement sum of bytes as 16-bit words in native
+ * byte order.  The sum is byte order independent (RFC 1071) and so may be
+ * combined with sums from CalcIPChecksum, which also reads native words,
+ * without swapping.  The bytes need not be aligned.  An odd final byte is
+ * padded with a zero byte, which assumes a little-endian CPU.
+ * @param bytes Address of bytes.
+ * @param numberOfBytes Number of bytes.
+ * @return Ones' complement sum.
+ */
+static WORD GetSum(const BYTE* const bytes, const size_t numberOfBytes) {
+    DWORD sum = 0;
+    size_t index;
+    for (index = 0; (index + 1) < numberOfBytes; index += sizeof (WORD)) {
+        WORD word;
+        memcpy(&word, &bytes[index], sizeof (WORD));
+        sum += word;
+    }
+    if ((numberOfBytes % 2) != 0) {
+        sum += bytes[numberOfBytes - 1];
+    }
+    while ((sum >> 16) != 0) {
+        sum = (sum & 0xFFFF) + (sum >> 16); // end-around carry
+    }
+    return (WORD) sum;
+}
+
+/**
+ * @brief Gets the time of arrival of a received packet or the time of
+ * transmission of a prepared packet.  This function is called by the Ethernet
+ * RX done and TX done interrupts.
+ * @return Timer ticks value.
+ */
+static QWORD GetTimestamp() {
+    return TimerGetTicks64().value;
+}
+
+/**
+ * @brief Updates a UDP checksum for modified bytes without recalculating the
+ * checksum of the whole packet.  See RFC 1624.
+ * @param checksum Original checksum.
+ * @param oldBytes Address of original bytes.
+ * @param newBytes Address of modified bytes.
+ * @param numberOfBytes Number of bytes.  Must be even.
+ * @return Updated checksum.
+ */
+static WORD UpdateChecksum(const WORD checksum, const BYTE* const oldBytes, const BYTE* const newBytes, const size_t numberOfBytes) {
+    if (checksum == 0x0000) {
+        return 0x0000; // checksum not used
+    }
+    uint32_t sum = (WORD) ~checksum;
+    size_t index;
+    for (index = 0; index < numberOfBytes; index += sizeof (WORD)) {
+        WORD oldWord;
+        WORD newWord;
+        memcpy(&oldWord, &oldBytes[index], sizeof (WORD));
+        memcpy(&newWord, &newBytes[index], sizeof (WORD));
+        sum += (WORD) ~oldWord;
+        sum += newWord;
+    }
+    while ((sum >> 16) != 0) {
+        sum = (sum & 0xFFFF) + (sum >> 16); // end-around carry
+    }
+    const WORD newChecksum = ~sum;
+    return newChecksum == 0x0000 ? 0xFFFF : newChecksum; // 0 indicates checksum not used
+}
+
+/**
+ * @brief Makes the socket active and gets its transmit buffer.
+ * @param socket Socket.
+ * @param destination Address where the transmit buffer address will be
+ * written.
+ * @param destinationSize Address where the size of the transmit buffer will
+ * be written.
+ * @return 0 if successful.
+ */
+static int GetBuffer(const UDP_SOCKET socket, char* * const destination, size_t * const destinationSize) {
+    if (!MACIsLinked()) {
+        return 1; // error: no link
+    }
+    if (UDPIsPutReady(socket) == 0) {
+        return 1; // error: socket not ready
     }
+    WORD available;
+    *destination = (char*) UDPGetTxPointer(&available);
+    *destinationSize = available;
     return 0;
 }
 
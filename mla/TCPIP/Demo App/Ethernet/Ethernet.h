@@ -10,16 +10,41 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t, NULL
+#include <stdint.h> // uint8_t, uint16_t
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Remote UDP endpoint.  The MAC address is that of the remote host, or
+ * of the gateway if the remote host is on another subnet.
+ */
+typedef struct {
+    uint8_t macAddress[6];
+    uint8_t ipAddress[4];
+    uint16_t port;
+} EthernetEndpoint;
 
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void EthernetInitialise();
 void EthernetDoTasks();
+bool EthernetIsLinked();
 int EthernetUnicast(const char* const source, const size_t numberOfBytes);
 int EthernetBroadcast(const char* const source, const size_t numberOfBytes);
-size_t EthernetGet(const char* const destination, const size_t destinationSize);
+int EthernetUnicastToEach(const EthernetEndpoint * const endpoints, const size_t numberOfEndpoints, const char* const source, const size_t numberOfBytes, size_t * const numberOfEndpointsSent);
+int EthernetBroadcastPrepared(const size_t index, const char* const source, const size_t numberOfBytes);
+int EthernetGetUnicastBuffer(char* * const destination, size_t * const destinationSize);
+int EthernetGetBroadcastBuffer(char* * const destination, size_t * const destinationSize);
+int EthernetSendBuffer(const size_t numberOfBytes);
+int EthernetPrepareBuffer(const size_t numberOfBytes);
+int EthernetGetTransmitTime(Ticks64 * const transmitTime);
+size_t EthernetGet(char* const destination, const size_t destinationSize, Ticks64 * const timeOfArrival);
+void EthernetGetSender(EthernetEndpoint * const sender);
 
 #endif
 
@@ -13,7 +13,9 @@
 //------------------------------------------------------------------------------
 // Includes
 
+#include "Benchmark/Benchmark.h"
 #include "Ethernet/Ethernet.h"
+#include "Receive/Receive.h"
 #include "Send/Send.h"
 #include "stdbool.h"
 #include "Synchronisation/Synchronisation.h"
@@ -48,12 +50,20 @@ int main(void) {
     TimerInitialise();
     SynchronisationInitialise();
     EthernetInitialise();
+    ReceiveInitialise();
     SendInitialise();
+#ifdef BENCHMARK_ENABLED
+    BenchmarkInitialise();
+#endif
 
     // Main loop
     while (true) {
         EthernetDoTasks();
+        ReceiveDoTasks();
         SendDoTasks();
+#ifdef BENCHMARK_ENABLED
+        BenchmarkDoTasks();
+#endif
     }
 }
 
@@ -24,6 +24,10 @@ extern "C" {
 #endif
 
 #include "OscAddress.h"
+#include "OscBundleWriter.h"
+#include "OscMessageTemplate.h"
+#include "OscMessageView.h"
+#include "OscMessageWriter.h"
 #include "OscPacket.h"
 #include "OscSlip.h"
 
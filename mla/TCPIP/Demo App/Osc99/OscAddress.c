@@ -12,15 +12,32 @@
 #include "OscAddress.h"
 #include <string.h>
 
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of 32-bit words required to store one bit for each character
+ * position of an OSC address, including the terminating null character.
+ */
+#define STAR_MATCHES_SIZE ((MAX_OSC_ADDRESS_LENGTH + 1 + 31) / 32)
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
 static bool MatchLiteral(const char* oscAddressPattern, const char* oscAddress, const bool isPartial);
-static bool MatchExpression(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
-static bool MatchStar(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
+static bool MatchExpression(const char* const oscAddressPattern, const char* const oscAddress, const bool isPartial);
+static bool MatchSequence(const char* oscAddressPattern, const char* oscAddress, const char* const oscAddressStart, const uint32_t * const starMatches, const bool isPartial);
+static bool MatchStar(const char* const oscAddressPattern, const char* const oscAddressStart, const size_t index, const uint32_t * const starMatches, const uint32_t * const nextStarMatches, const bool isPartial);
+static int GetNumberOfStars(const char* oscAddressPattern);
+static const char* GetStarAtIndex(const char* oscAddressPattern, const int starIndex);
+static const char* SkipCharacter(const char* oscAddressPattern);
+static bool GetStarMatch(const uint32_t * const starMatches, const size_t index);
+static void SetStarMatch(uint32_t * const starMatches, const size_t index, const bool match);
 static bool MatchCharacter(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
 static bool MatchBrackets(const char* * const oscAddressPattern, const char* * const oscAddress);
 static bool MatchCurlyBraces(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
+static bool IsSpecialCharacter(const char character);
+static int FindChild(const OscAddressDispatcher * const oscAddressDispatcher, const int parent, const char character);
 
 //------------------------------------------------------------------------------
 // Functions
@@ -106,7 +123,7 @@ static bool MatchLiteral(const char* oscAddressPattern, const char* oscAddress,
             if (isPartial) {
                 return true;
             } else {
-                return MatchExpression(&oscAddressPattern, &oscAddress, isPartial); // handle trailing 'zero character' expressions
+                return MatchExpression(oscAddressPattern, oscAddress, isPartial); // handle trailing 'zero character' expressions
             }
             return false; // fail: OSC address pattern too short
         }
@@ -115,7 +132,7 @@ static bool MatchLiteral(const char* oscAddressPattern, const char* oscAddress,
             case '*':
             case '[':
             case '{':
-                return MatchExpression(&oscAddressPattern, &oscAddress, isPartial);
+                return MatchExpression(oscAddressPattern, oscAddress, isPartial);
             default:
                 if (*oscAddressPattern != *oscAddress) {
                     return false; // fail: character mismatch
@@ -137,6 +154,21 @@ static bool MatchLiteral(const char* oscAddressPattern, const char* oscAddress,
  * The OSC address pattern expression may contain any combination of special
  * characters: '?', '*', '[]' or '{}'.
  *
+ * A star followed by further characters within the same part may match a
+ * sequence of any length and so each possible match must be attempted.  Rather
+ * than attempt each possible match recursively, the result of the remainder of
+ * the expression following each star is determined once for every character
+ * position in the target OSC address.  Stars are evaluated from last to first
+ * so that the results for the following star are always available.  The
+ * processing time is therefore proportional to the product of the OSC address
+ * pattern length and the target OSC address length, and the stack usage is
+ * constant.
+ *
+ * The result is identical to that of a recursive search of each possible star
+ * match except where the recursive search would not complete: a zero-length
+ * match that would be repeated indefinitely and a match beyond the terminating
+ * null character of the target OSC address are both treated as a fail.
+ *
  * This is an internal function and cannot be called by the user application.
  *
  * @param oscAddressPattern Pointer to first character of OSC address pattern.
@@ -144,89 +176,250 @@ static bool MatchLiteral(const char* oscAddressPattern, const char* oscAddress,
  * @param isPartial Flag indicating if a partial match is acceptable.
  * @return true if OSC address pattern and target OSC address match.
  */
-static bool MatchExpression(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial) {
-    while (**oscAddressPattern != '\0') {
-        if (**oscAddress == '\0') {
+static bool MatchExpression(const char* const oscAddressPattern, const char* const oscAddress, const bool isPartial) {
+    const size_t oscAddressLength = strlen(oscAddress);
+    if (oscAddressLength > MAX_OSC_ADDRESS_LENGTH) {
+        return false; // fail: target OSC address too long
+    }
+
+    // Determine matches for each star from last to first
+    uint32_t starMatches[2][STAR_MATCHES_SIZE];
+    int starIndex;
+    for (starIndex = GetNumberOfStars(oscAddressPattern) - 1; starIndex >= 0; starIndex--) {
+        uint32_t * const currentStarMatches = starMatches[starIndex % 2];
+        const uint32_t * const nextStarMatches = starMatches[(starIndex + 1) % 2];
+        const char* const star = GetStarAtIndex(oscAddressPattern, starIndex);
+        size_t index = oscAddressLength + 1;
+        while (index-- > 0) {
+            SetStarMatch(currentStarMatches, index, MatchStar(star, oscAddress, index, currentStarMatches, nextStarMatches, isPartial));
+        }
+    }
+
+    // Match expression using matches for first star
+    return MatchSequence(oscAddressPattern, oscAddress, oscAddress, starMatches[0], isPartial);
+}
+
+/**
+ * @brief Matches an OSC address pattern expression with a target OSC address
+ * up to the next star that may match a sequence of any length.
+ *
+ * The result for the remainder of the expression from that star is provided by
+ * the matches previously determined for the star.  A star that is the last
+ * character within a part is matched to the remainder of the part in the
+ * target OSC address.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscAddressPattern Pointer to first character of OSC address pattern.
+ * @param oscAddress Pointer to first character of target OSC address.
+ * @param oscAddressStart Pointer to character of target OSC address
+ * corresponding to the first star match.
+ * @param starMatches Matches for the next star.
+ * @param isPartial Flag indicating if a partial match is acceptable.
+ * @return true if OSC address pattern and target OSC address match.
+ */
+static bool MatchSequence(const char* oscAddressPattern, const char* oscAddress, const char* const oscAddressStart, const uint32_t * const starMatches, const bool isPartial) {
+    while (*oscAddressPattern != '\0') {
+        if (*oscAddress == '\0') {
             if (isPartial) {
                 return true;
             }
         }
-        if (**oscAddressPattern == '*') {
-            if (!MatchStar(oscAddressPattern, oscAddress, isPartial)) {
-                return false; // fail: unable to match star sequence
+        if (*oscAddressPattern == '*') {
+
+            // Advance OSC address pattern pointer to character proceeding star(s)
+            while (*oscAddressPattern == '*') {
+                oscAddressPattern++;
             }
-        } else {
-            if (!MatchCharacter(oscAddressPattern, oscAddress, isPartial)) {
-                return false; // fail: unable to match single character, bracketed list or curly braced list
+
+            // Advance OSC address pointer to end of part if star is last character
+            if (*oscAddressPattern == '/' || *oscAddressPattern == '\0') {
+                while (*oscAddress != '/' && *oscAddress != '\0') {
+                    oscAddress++;
+                }
+                continue;
             }
+
+            // Else remainder of expression determined by star matches
+            return GetStarMatch(starMatches, oscAddress - oscAddressStart);
+        }
+        if (!MatchCharacter(&oscAddressPattern, &oscAddress, isPartial)) {
+            return false; // fail: unable to match single character, bracketed list or curly braced list
         }
     }
-    if (**oscAddress != '\0') {
+    if (*oscAddress != '\0') {
         return false; // fail: OSC address pattern too long
     }
     return true;
 }
 
 /**
- * @brief Matches an OSC address pattern expression starting with a star with
- * the next character(s) in the target OSC address.
+ * @brief Determines if the remainder of an OSC address pattern expression
+ * following a star matches the target OSC address from the specified index.
  *
- * The OSC address pattern must start with a '*' character.  A '*' character
- * will be matched to any sequence of zero or more characters in the OSC address
- * up to the next '/' character or to the end of the OSC address.  For example,
- * the OSC address pattern "/colour/b*" would match the OSC addresses
- * "/colour/blue", "/colour/black" and "/colour/brown".
+ * A '*' character will be matched to any sequence of zero or more characters in
+ * the OSC address up to the next '/' character or to the end of the OSC
+ * address.  For example, the OSC address pattern "/colour/b*" would match the
+ * OSC addresses "/colour/blue", "/colour/black" and "/colour/brown".
  *
- * The oscAddressPattern and oscAddress pointers are advanced to the character
- * proceeding the matched sequence. This function calls MatchCharacter and so
- * becomes recursive if the expression contains multiple stars.
+ * The character proceeding the star is matched at the specified index.  If the
+ * remainder of the expression does not match then the result is that of the
+ * next index, previously determined.  Each result therefore depends only on
+ * results for greater indexes and the results for the next star.
  *
  * This is an internal function and cannot be called by the user application.
  *
- * @param oscAddressPattern Pointer to first character of OSC address pattern.
- * @param oscAddress Pointer to first character of target OSC address.
+ * @param oscAddressPattern Pointer to character proceeding star(s).
+ * @param oscAddressStart Pointer to character of target OSC address
+ * corresponding to index 0.
+ * @param index Index of character in target OSC address.
+ * @param starMatches Matches for this star.  Only greater indexes are valid.
+ * @param nextStarMatches Matches for the next star.
  * @param isPartial Flag indicating if a partial match is acceptable.
  * @return true if OSC address pattern and target OSC address match.
  */
-static bool MatchStar(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial) {
-
-    // Advance OSC address pattern pointer to character proceeding star(s)
-    while (**oscAddressPattern == '*') {
-        (*oscAddressPattern)++;
+static bool MatchStar(const char* const oscAddressPattern, const char* const oscAddressStart, const size_t index, const uint32_t * const starMatches, const uint32_t * const nextStarMatches, const bool isPartial) {
+    const char* oscAddressPatternCursor = oscAddressPattern;
+    const char* oscAddress = &oscAddressStart[index];
+    if (MatchCharacter(&oscAddressPatternCursor, &oscAddress, isPartial)) {
+        if (MatchSequence(oscAddressPatternCursor, oscAddress, oscAddressStart, nextStarMatches, isPartial)) {
+            return true;
+        }
+        if (oscAddress == &oscAddressStart[index]) {
+            return false; // fail: zero-length match cannot advance
+        }
+        return GetStarMatch(starMatches, oscAddress - oscAddressStart);
     }
-
-    // Advance OSC address pattern pointer to end of part if star is last character
-    if (**oscAddressPattern == '/' || **oscAddressPattern == '\0') {
-        while (**oscAddress != '/' && **oscAddress != '\0') {
-            (*oscAddress)++;
+    if (oscAddressStart[index] == '\0') {
+        return false; // fail: end of OSC address
+    }
+    if (oscAddressStart[index + 1] == '/' || oscAddressStart[index + 1] == '\0') {
+        if (isPartial && oscAddressStart[index + 1] == '\0') {
+            return true;
         }
-        return true;
+        return false; // fail: OSC address pattern part ended before match
     }
+    return GetStarMatch(starMatches, index + 1);
+}
 
-    // Attempt to match remainder of expression for each possible star match
-    do {
-        const char* oscAddressPatternCache = *oscAddressPattern; // cache character oscAddress proceeding star
+/**
+ * @brief Returns the number of stars within an OSC address pattern expression
+ * that may match a sequence of any length.  Consecutive stars are counted as
+ * one star and a star that is the last character within a part is not
+ * counted.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscAddressPattern Pointer to first character of OSC address pattern.
+ * @return Number of stars.
+ */
+static int GetNumberOfStars(const char* oscAddressPattern) {
+    int numberOfStars = 0;
+    while (oscAddressPattern != NULL && *oscAddressPattern != '\0') {
+        if (*oscAddressPattern == '*') {
+            while (*oscAddressPattern == '*') {
+                oscAddressPattern++;
+            }
+            if (*oscAddressPattern != '/' && *oscAddressPattern != '\0') {
+                numberOfStars++;
+            }
+            continue;
+        }
+        oscAddressPattern = SkipCharacter(oscAddressPattern);
+    }
+    return numberOfStars;
+}
 
-        // Advance OSC address pattern to next match of character proceeding star
-        while (!MatchCharacter(oscAddressPattern, oscAddress, isPartial)) {
-            (*oscAddress)++;
-            if (**oscAddress == '/' || **oscAddress == '\0') {
-                if (isPartial && **oscAddress == '\0') {
-                    return true;
+/**
+ * @brief Returns a pointer to the character proceeding the star at the
+ * specified index within an OSC address pattern expression.  Stars are indexed
+ * as per GetNumberOfStars.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscAddressPattern Pointer to first character of OSC address pattern.
+ * @param starIndex Index of star.
+ * @return Pointer to character proceeding star.  NULL if the star does not
+ * exist.
+ */
+static const char* GetStarAtIndex(const char* oscAddressPattern, const int starIndex) {
+    int starCount = 0;
+    while (oscAddressPattern != NULL && *oscAddressPattern != '\0') {
+        if (*oscAddressPattern == '*') {
+            while (*oscAddressPattern == '*') {
+                oscAddressPattern++;
+            }
+            if (*oscAddressPattern != '/' && *oscAddressPattern != '\0') {
+                if (starCount++ == starIndex) {
+                    return oscAddressPattern;
                 }
-                return false; // fail: OSC address pattern part ended before match
             }
+            continue;
         }
-        const char* oscAddressCache = (*oscAddress); // cache character oscAddress proceeding current star match
+        oscAddressPattern = SkipCharacter(oscAddressPattern);
+    }
+    return NULL;
+}
 
-        // Attempt to match remainder of expression
-        if (MatchExpression(oscAddressPattern, oscAddress, isPartial)) { // potentially recursive
-            return true;
-        } else {
-            *oscAddressPattern = oscAddressPatternCache;
-            *oscAddress = oscAddressCache;
+/**
+ * @brief Returns a pointer to the character proceeding a single character,
+ * bracketed list or curly braced list within an OSC address pattern.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscAddressPattern Pointer to first character of OSC address pattern.
+ * @return Pointer to proceeding character.  NULL if the bracketed list or
+ * curly braced list is unbalanced.
+ */
+static const char* SkipCharacter(const char* oscAddressPattern) {
+    char closingCharacter;
+    switch (*oscAddressPattern) {
+        case '[':
+            closingCharacter = ']';
+            break;
+        case '{':
+            closingCharacter = '}';
+            break;
+        default:
+            return oscAddressPattern + 1;
+    }
+    while (*oscAddressPattern != closingCharacter) {
+        if (*oscAddressPattern == '/' || *oscAddressPattern == '\0') {
+            return NULL; // unbalanced brackets or curly braces
         }
-    } while (true);
+        oscAddressPattern++;
+    }
+    return oscAddressPattern + 1;
+}
+
+/**
+ * @brief Gets the star match for the specified index.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param starMatches Star matches.
+ * @param index Index of character in target OSC address.
+ * @return Star match.
+ */
+static bool GetStarMatch(const uint32_t * const starMatches, const size_t index) {
+    return (starMatches[index / 32] & (1ul << (index % 32))) != 0;
+}
+
+/**
+ * @brief Sets the star match for the specified index.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param starMatches Star matches.
+ * @param index Index of character in target OSC address.
+ * @param match Star match.
+ */
+static void SetStarMatch(uint32_t * const starMatches, const size_t index, const bool match) {
+    if (match) {
+        starMatches[index / 32] |= 1ul << (index % 32);
+    } else {
+        starMatches[index / 32] &= ~(1ul << (index % 32));
+    }
 }
 
 /**
@@ -250,7 +443,7 @@ static bool MatchCharacter(const char* * const oscAddressPattern, const char* *
     const char* oscAddressCache = *oscAddress;
     switch (**oscAddressPattern) {
         case '[':
-            if (MatchBrackets(oscAddressPattern, oscAddress)) {
+            if (**oscAddress != '\0' && MatchBrackets(oscAddressPattern, oscAddress)) {
                 return true;
             }
             break;
@@ -264,7 +457,7 @@ static bool MatchCharacter(const char* * const oscAddressPattern, const char* *
         case '}':
             break; // fail: unbalanced curly braces
         default:
-            if (**oscAddressPattern == **oscAddress || **oscAddressPattern == '?') {
+            if (**oscAddress != '\0' && (**oscAddressPattern == **oscAddress || **oscAddressPattern == '?')) {
                 (*oscAddressPattern)++;
                 (*oscAddress)++;
                 return true;
@@ -519,5 +712,202 @@ int OscAddressGetPartAtIndex(const char* oscAddressPattern, const int index, cha
     return 0;
 }
 
+/**
+ * @brief Initialises an OSC address dispatcher.
+ *
+ * An OSC address dispatcher compiles the OSC addresses of registered methods
+ * into a trie so that an OSC address pattern without special characters is
+ * resolved in a single pass of its characters, regardless of the number of
+ * methods.  An OSC address pattern containing special characters ('?', '*',
+ * '[]' or '{}') is matched against each method using OscAddressMatch.
+ *
+ * Example use:
+ * @code
+ * void Example(void* const context) {
+ *     OscMessage * const oscMessage = context;
+ *     printf("Match!");
+ * }
+ *
+ * OscAddressDispatcher oscAddressDispatcher;
+ * OscAddressDispatcherInitialise(&oscAddressDispatcher);
+ * OscAddressDispatcherAddMethod(&oscAddressDispatcher, "/example", Example);
+ * OscAddressDispatcherDispatch(&oscAddressDispatcher, oscMessage.oscAddressPattern, &oscMessage);
+ * @endcode
+ *
+ * @param oscAddressDispatcher Address of the OSC address dispatcher structure.
+ */
+void OscAddressDispatcherInitialise(OscAddressDispatcher * const oscAddressDispatcher) {
+    oscAddressDispatcher->numberOfMethods = 0;
+    oscAddressDispatcher->nodes[0].character = '\0'; // root node
+    oscAddressDispatcher->nodes[0].firstChild = -1;
+    oscAddressDispatcher->nodes[0].nextSibling = -1;
+    oscAddressDispatcher->nodes[0].methodIndex = -1;
+    oscAddressDispatcher->numberOfNodes = 1;
+}
+
+/**
+ * @brief Registers a method with an OSC address dispatcher.
+ *
+ * The OSC address must start with a '/' character and cannot contain any
+ * special characters: '?', '*', '[]' or '{}'.  Each OSC address may only be
+ * registered once.  The OSC address string is not copied and so must remain
+ * valid for as long as the OSC address dispatcher is used.
+ *
+ * @param oscAddressDispatcher Address of the OSC address dispatcher structure.
+ * @param oscAddress OSC address of the method.
+ * @param function Function to be called when the OSC address is matched.
+ * @return 0 if successful.
+ */
+int OscAddressDispatcherAddMethod(OscAddressDispatcher * const oscAddressDispatcher, const char* const oscAddress, void (*function)(void* const context)) {
+    if (oscAddressDispatcher->numberOfMethods >= MAX_NUMBER_OF_OSC_ADDRESS_METHODS) {
+        return 1; // error: too many methods
+    }
+    if (*oscAddress != '/') {
+        return 1; // error: OSC address does not start with '/'
+    }
+
+    // Find existing nodes shared with OSC address
+    int node = 0; // root node
+    const char* character = oscAddress;
+    while (*character != '\0') {
+        if (IsSpecialCharacter(*character) || *character == ']' || *character == '}') {
+            return 1; // error: OSC address contains special character
+        }
+        const int child = FindChild(oscAddressDispatcher, node, *character);
+        if (child < 0) {
+            break;
+        }
+        node = child;
+        character++;
+    }
+
+    // Confirm that OSC address is valid and there are enough nodes for remaining characters
+    const char* const firstNewCharacter = character;
+    while (*character != '\0') {
+        if (IsSpecialCharacter(*character) || *character == ']' || *character == '}') {
+            return 1; // error: OSC address contains special character
+        }
+        character++;
+    }
+    if ((oscAddressDispatcher->numberOfNodes + (character - firstNewCharacter)) > MAX_NUMBER_OF_OSC_ADDRESS_NODES) {
+        return 1; // error: too many nodes
+    }
+
+    // Add nodes for remaining characters
+    for (character = firstNewCharacter; *character != '\0'; character++) {
+        OscAddressNode * const newNode = &oscAddressDispatcher->nodes[oscAddressDispatcher->numberOfNodes];
+        newNode->character = *character;
+        newNode->firstChild = -1;
+        newNode->nextSibling = oscAddressDispatcher->nodes[node].firstChild;
+        newNode->methodIndex = -1;
+        oscAddressDispatcher->nodes[node].firstChild = oscAddressDispatcher->numberOfNodes;
+        node = oscAddressDispatcher->numberOfNodes++;
+    }
+
+    // Add method
+    if (oscAddressDispatcher->nodes[node].methodIndex >= 0) {
+        return 1; // error: OSC address already registered
+    }
+    oscAddressDispatcher->nodes[node].methodIndex = oscAddressDispatcher->numberOfMethods;
+    oscAddressDispatcher->methods[oscAddressDispatcher->numberOfMethods].oscAddress = oscAddress;
+    oscAddressDispatcher->methods[oscAddressDispatcher->numberOfMethods].function = function;
+    oscAddressDispatcher->numberOfMethods++;
+    return 0;
+}
+
+/**
+ * @brief Calls the function of each method matched by an OSC address pattern.
+ *
+ * The OSC address pattern is resolved by following the trie one character at a
+ * time.  If a special character is found then each method is instead matched
+ * using OscAddressMatch and so the result is always identical to calling
+ * OscAddressMatch for every method.
+ *
+ * @param oscAddressDispatcher Address of the OSC address dispatcher structure.
+ * @param oscAddressPattern OSC address pattern.
+ * @param context Context passed to the function of each method matched.
+ * @return Number of methods matched.
+ */
+int OscAddressDispatcherDispatch(const OscAddressDispatcher * const oscAddressDispatcher, const char* const oscAddressPattern, void* const context) {
+
+    // Follow trie while OSC address pattern is literal
+    int node = 0; // root node
+    const char* character = oscAddressPattern;
+    while (*character != '\0') {
+        if (IsSpecialCharacter(*character)) {
+            break;
+        }
+        node = FindChild(oscAddressDispatcher, node, *character);
+        if (node < 0) {
+            return 0; // literal characters do not match any method
+        }
+        character++;
+    }
+
+    // Call method if OSC address pattern is literal
+    if (*character == '\0') {
+        const int methodIndex = oscAddressDispatcher->nodes[node].methodIndex;
+        if (methodIndex < 0) {
+            return 0;
+        }
+        oscAddressDispatcher->methods[methodIndex].function(context);
+        return 1;
+    }
+
+    // Else match OSC address pattern expression with each method
+    int numberOfMatches = 0;
+    int methodIndex;
+    for (methodIndex = 0; methodIndex < oscAddressDispatcher->numberOfMethods; methodIndex++) {
+        if (OscAddressMatch(oscAddressPattern, oscAddressDispatcher->methods[methodIndex].oscAddress)) {
+            oscAddressDispatcher->methods[methodIndex].function(context);
+            numberOfMatches++;
+        }
+    }
+    return numberOfMatches;
+}
+
+/**
+ * @brief Returns true if the character starts an OSC address pattern
+ * expression: '?', '*', '[' or '{'.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param character Character.
+ * @return true if the character starts an OSC address pattern expression.
+ */
+static bool IsSpecialCharacter(const char character) {
+    switch (character) {
+        case '?':
+        case '*':
+        case '[':
+        case '{':
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Finds the child of a trie node that represents the specified
+ * character.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscAddressDispatcher Address of the OSC address dispatcher structure.
+ * @param parent Index of the parent node.
+ * @param character Character.
+ * @return Index of the child node.  -1 if the child does not exist.
+ */
+static int FindChild(const OscAddressDispatcher * const oscAddressDispatcher, const int parent, const char character) {
+    int child = oscAddressDispatcher->nodes[parent].firstChild;
+    while (child >= 0) {
+        if (oscAddressDispatcher->nodes[child].character == character) {
+            return child;
+        }
+        child = oscAddressDispatcher->nodes[child].nextSibling;
+    }
+    return -1;
+}
+
 //------------------------------------------------------------------------------
 // End of file
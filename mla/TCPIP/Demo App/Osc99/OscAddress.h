@@ -3,6 +3,11 @@
  * @author Seb Madgwick
  * @brief Functions for matching and manipulating OSC address patterns and OSC
  * addresses.
+ *
+ * MAX_OSC_ADDRESS_LENGTH, MAX_NUMBER_OF_OSC_ADDRESS_METHODS and
+ * MAX_NUMBER_OF_OSC_ADDRESS_NODES may be modified as required by the user
+ * application.
+ *
  * @see http://opensoundcontrol.org/spec-1_0
  */
 
@@ -14,6 +19,63 @@
 
 #include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t
+#include <stdint.h> // int16_t, uint32_t
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum string length (excludes terminating null character) of a
+ * target OSC address that may be matched to an OSC address pattern containing
+ * special characters.  Matching requires one bit of stack for each character
+ * and so this value may be modified as required by the user application.
+ */
+#define MAX_OSC_ADDRESS_LENGTH 128
+
+/**
+ * @brief Maximum number of methods that may be registered with an OSC address
+ * dispatcher.  This value may be modified as required by the user application.
+ */
+#define MAX_NUMBER_OF_OSC_ADDRESS_METHODS 16
+
+/**
+ * @brief Maximum number of nodes within the trie of an OSC address dispatcher.
+ * One node is required for each character of each OSC address that is not
+ * shared with a previously registered OSC address.  This value may be modified
+ * as required by the user application.
+ */
+#define MAX_NUMBER_OF_OSC_ADDRESS_NODES 256
+
+/**
+ * @brief OSC address method.  The function is called with the context provided
+ * to OscAddressDispatcherDispatch when the method OSC address is matched.
+ */
+typedef struct {
+    const char* oscAddress;
+    void (*function)(void* const context);
+} OscAddressMethod;
+
+/**
+ * @brief Node of OSC address dispatcher trie.  Children of a node are stored
+ * as a linked list of siblings.  Index values of -1 indicate none.
+ */
+typedef struct {
+    char character;
+    int16_t firstChild;
+    int16_t nextSibling;
+    int16_t methodIndex;
+} OscAddressNode;
+
+/**
+ * @brief OSC address dispatcher structure.  Must be initialised using
+ * OscAddressDispatcherInitialise.
+ */
+typedef struct {
+    OscAddressMethod methods[MAX_NUMBER_OF_OSC_ADDRESS_METHODS];
+    int numberOfMethods;
+    OscAddressNode nodes[MAX_NUMBER_OF_OSC_ADDRESS_NODES];
+    int numberOfNodes;
+} OscAddressDispatcher;
 
 //------------------------------------------------------------------------------
 // Function prototypes
@@ -22,6 +84,9 @@ bool OscAddressMatch(const char* oscAddressPattern, const char* const oscAddress
 bool OscAddressMatchPartial(const char* oscAddressPattern, const char* const oscAddress);
 int OscAddressGetNumberOfParts(const char* oscAddressPattern);
 int OscAddressGetPartAtIndex(const char* oscAddressPattern, const int index, char* const destination, const size_t destinationSize);
+void OscAddressDispatcherInitialise(OscAddressDispatcher * const oscAddressDispatcher);
+int OscAddressDispatcherAddMethod(OscAddressDispatcher * const oscAddressDispatcher, const char* const oscAddress, void (*function)(void* const context));
+int OscAddressDispatcherDispatch(const OscAddressDispatcher * const oscAddressDispatcher, const char* const oscAddressPattern, void* const context);
 
 #endif
 
@@ -0,0 +1,198 @@
+/**
+ * @file OscBundleWriter.c
+ * @author Seb Madgwick
+ * @brief Functions and structures for constructing OSC bundles in place.
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscBundle.h"
+#include "OscBundleWriter.h"
+#include <stdint.h> // uint32_t
+#include <string.h> // memcpy
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static int WriteHeader(OscBundleWriter * const oscBundleWriter, const OscTimeTag oscTimeTag);
+static void WriteWord(char* const destination, const uint32_t word);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises an OSC bundle writer and writes the OSC bundle header and
+ * OSC time tag to the destination.
+ *
+ * Example use:
+ * @code
+ * char destination[256];
+ * OscBundleWriter oscBundleWriter;
+ * OscBundleWriterInitialise(&oscBundleWriter, destination, sizeof(destination), OSC_TIME_TAG_ZERO);
+ * OscMessageWriter oscMessageWriter;
+ * OscBundleWriterOpenMessage(&oscBundleWriter, &oscMessageWriter, "/example", ",i");
+ * OscMessageWriterAddInt32(&oscMessageWriter, 123);
+ * OscBundleWriterCloseMessage(&oscBundleWriter, &oscMessageWriter);
+ * size_t oscBundleSize;
+ * OscBundleWriterFinalise(&oscBundleWriter, &oscBundleSize);
+ * @endcode
+ *
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @param destination Address of the destination char array.
+ * @param destinationSize Size of the destination that cannot be exceeded.
+ * @param oscTimeTag OSC time tag.
+ * @return 0 if successful.
+ */
+int OscBundleWriterInitialise(OscBundleWriter * const oscBundleWriter, char* const destination, const size_t destinationSize, const OscTimeTag oscTimeTag) {
+    oscBundleWriter->destination = destination;
+    oscBundleWriter->destinationSize = destinationSize;
+    oscBundleWriter->size = 0;
+    oscBundleWriter->openBundleIndex = 0;
+    return WriteHeader(oscBundleWriter, oscTimeTag);
+}
+
+/**
+ * @brief Opens an OSC message element and initialises an OSC message writer to
+ * write the OSC message in place.
+ *
+ * The OSC message writer is used to add each argument as normal and must then
+ * be passed to OscBundleWriterCloseMessage.  No other OSC bundle writer
+ * function may be called while an OSC message is open.
+ *
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param oscAddressPattern OSC address pattern as null terminated string.
+ * @param oscTypeTagString OSC type tag string (including comma) as null
+ * terminated string.
+ * @return 0 if successful.
+ */
+int OscBundleWriterOpenMessage(OscBundleWriter * const oscBundleWriter, OscMessageWriter * const oscMessageWriter, const char* oscAddressPattern, const char* oscTypeTagString) {
+    const size_t elementIndex = oscBundleWriter->size + sizeof (uint32_t); // leave space for element size
+    if (elementIndex > oscBundleWriter->destinationSize) {
+        return 1; // error: destination full
+    }
+    return OscMessageWriterInitialise(oscMessageWriter, &oscBundleWriter->destination[elementIndex], oscBundleWriter->destinationSize - elementIndex, oscAddressPattern, oscTypeTagString);
+}
+
+/**
+ * @brief Closes an OSC message element opened by OscBundleWriterOpenMessage
+ * and writes the element size.
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @return 0 if successful.
+ */
+int OscBundleWriterCloseMessage(OscBundleWriter * const oscBundleWriter, OscMessageWriter * const oscMessageWriter) {
+    if (oscMessageWriter->destination != &oscBundleWriter->destination[oscBundleWriter->size + sizeof (uint32_t)]) {
+        return 1; // error: message not opened by this bundle writer
+    }
+    size_t oscMessageSize;
+    if (OscMessageWriterFinalise(oscMessageWriter, &oscMessageSize) != 0) {
+        return 1; // error: incomplete message
+    }
+    WriteWord(&oscBundleWriter->destination[oscBundleWriter->size], oscMessageSize);
+    oscBundleWriter->size += sizeof (uint32_t) + oscMessageSize;
+    return 0;
+}
+
+/**
+ * @brief Opens a nested OSC bundle element and writes its OSC bundle header
+ * and OSC time tag.  Subsequent elements are written within the nested OSC
+ * bundle until OscBundleWriterCloseBundle is called.
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @param oscTimeTag OSC time tag of the nested OSC bundle.
+ * @return 0 if successful.
+ */
+int OscBundleWriterOpenBundle(OscBundleWriter * const oscBundleWriter, const OscTimeTag oscTimeTag) {
+    const size_t elementSizeIndex = oscBundleWriter->size;
+    if ((elementSizeIndex + sizeof (uint32_t)) > oscBundleWriter->destinationSize) {
+        return 1; // error: destination full
+    }
+    const uint32_t openBundleIndex = oscBundleWriter->openBundleIndex;
+    memcpy(&oscBundleWriter->destination[elementSizeIndex], &openBundleIndex, sizeof (uint32_t)); // element size holds index of enclosing open bundle until closed
+    oscBundleWriter->size += sizeof (uint32_t);
+    if (WriteHeader(oscBundleWriter, oscTimeTag) != 0) {
+        oscBundleWriter->size = elementSizeIndex;
+        return 1; // error: destination full
+    }
+    oscBundleWriter->openBundleIndex = elementSizeIndex;
+    return 0;
+}
+
+/**
+ * @brief Closes the innermost nested OSC bundle element opened by
+ * OscBundleWriterOpenBundle and writes the element size.
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @return 0 if successful.
+ */
+int OscBundleWriterCloseBundle(OscBundleWriter * const oscBundleWriter) {
+    const size_t elementSizeIndex = oscBundleWriter->openBundleIndex;
+    if (elementSizeIndex == 0) {
+        return 1; // error: no nested bundle open
+    }
+    uint32_t openBundleIndex;
+    memcpy(&openBundleIndex, &oscBundleWriter->destination[elementSizeIndex], sizeof (uint32_t));
+    WriteWord(&oscBundleWriter->destination[elementSizeIndex], oscBundleWriter->size - (elementSizeIndex + sizeof (uint32_t)));
+    oscBundleWriter->openBundleIndex = openBundleIndex;
+    return 0;
+}
+
+/**
+ * @brief Completes the OSC bundle and provides its size.
+ *
+ * This function will return an error if any nested OSC bundle has not been
+ * closed.  The destination then contains a complete OSC bundle of the size
+ * provided.
+ *
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @param oscBundleSize Address where the size of the OSC bundle will be
+ * written.
+ * @return 0 if successful.
+ */
+int OscBundleWriterFinalise(OscBundleWriter * const oscBundleWriter, size_t * const oscBundleSize) {
+    *oscBundleSize = 0; // size will be 0 if function unsuccessful
+    if (oscBundleWriter->openBundleIndex != 0) {
+        return 1; // error: nested bundle not closed
+    }
+    *oscBundleSize = oscBundleWriter->size;
+    return 0;
+}
+
+/**
+ * @brief Writes an OSC bundle header and OSC time tag to the destination.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscBundleWriter Address of the OSC bundle writer structure.
+ * @param oscTimeTag OSC time tag.
+ * @return 0 if successful.
+ */
+static int WriteHeader(OscBundleWriter * const oscBundleWriter, const OscTimeTag oscTimeTag) {
+    if ((oscBundleWriter->size + MIN_OSC_BUNDLE_SIZE) > oscBundleWriter->destinationSize) {
+        return 1; // error: destination full
+    }
+    memcpy(&oscBundleWriter->destination[oscBundleWriter->size], OSC_BUNDLE_HEADER, sizeof (OSC_BUNDLE_HEADER));
+    oscBundleWriter->size += sizeof (OSC_BUNDLE_HEADER);
+    WriteWord(&oscBundleWriter->destination[oscBundleWriter->size], oscTimeTag.dwordStruct.seconds);
+    oscBundleWriter->size += sizeof (uint32_t);
+    WriteWord(&oscBundleWriter->destination[oscBundleWriter->size], oscTimeTag.dwordStruct.fraction);
+    oscBundleWriter->size += sizeof (uint32_t);
+    return 0;
+}
+
+/**
+ * @brief Writes a 32-bit word to the destination in big-endian byte order.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param destination Destination address.
+ * @param word 32-bit word to be written.
+ */
+static void WriteWord(char* const destination, const uint32_t word) {
+    const uint32_t bigEndianWord = OSC_BIG_ENDIAN_32(word);
+    memcpy(destination, &bigEndianWord, sizeof (uint32_t));
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,53 @@
+/**
+ * @file OscBundleWriter.h
+ * @author Seb Madgwick
+ * @brief Functions and structures for constructing OSC bundles in place.
+ *
+ * An OSC bundle writer serialises an OSC bundle directly into a destination
+ * char array, such as a transport transmit buffer.  Each OSC bundle element is
+ * written in place and the 4-byte element size is written once the element is
+ * closed.  OSC messages are written using an OscMessageWriter.  Nested OSC
+ * bundles are tracked within the unused element size bytes so that the writer
+ * structure is of a fixed size regardless of the depth of nesting.
+ *
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+#ifndef OSC_BUNDLE_WRITER_H
+#define OSC_BUNDLE_WRITER_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscCommon.h"
+#include "OscMessageWriter.h"
+#include <stddef.h> // size_t, NULL
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief OSC bundle writer structure.  Must be initialised using
+ * OscBundleWriterInitialise.
+ */
+typedef struct {
+    char* destination;
+    size_t destinationSize;
+    size_t size; // number of bytes written to destination
+    size_t openBundleIndex; // index of element size of innermost open nested bundle, 0 if none
+} OscBundleWriter;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+int OscBundleWriterInitialise(OscBundleWriter * const oscBundleWriter, char* const destination, const size_t destinationSize, const OscTimeTag oscTimeTag);
+int OscBundleWriterOpenMessage(OscBundleWriter * const oscBundleWriter, OscMessageWriter * const oscMessageWriter, const char* oscAddressPattern, const char* oscTypeTagString);
+int OscBundleWriterCloseMessage(OscBundleWriter * const oscBundleWriter, OscMessageWriter * const oscMessageWriter);
+int OscBundleWriterOpenBundle(OscBundleWriter * const oscBundleWriter, const OscTimeTag oscTimeTag);
+int OscBundleWriterCloseBundle(OscBundleWriter * const oscBundleWriter);
+int OscBundleWriterFinalise(OscBundleWriter * const oscBundleWriter, size_t * const oscBundleSize);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
@@ -34,6 +34,17 @@
  */
 #define LITTLE_ENDIAN_PLATFORM
 
+/**
+ * @brief Macro that converts a 32-bit word between host byte order and the
+ * big-endian byte order of OSC arguments.  The GCC built-in compiles to a
+ * wsbh and rotr instruction pair on PIC32MX.
+ */
+#ifdef LITTLE_ENDIAN_PLATFORM
+#define OSC_BIG_ENDIAN_32(word) __builtin_bswap32(word)
+#else
+#define OSC_BIG_ENDIAN_32(word) (word)
+#endif
+
 //------------------------------------------------------------------------------
 // Definitions - OSC contents
 
@@ -10,11 +10,17 @@
 // Includes
 
 #include "OscMessage.h"
+#include <string.h> // memcpy, memset
 
 //------------------------------------------------------------------------------
 // Function prototypes
 
 static int TerminateOscString(char* const oscString, size_t * const oscStringSize, const size_t maxOscStringSize);
+static int AddArray32(OscMessage * const oscMessage, const OscTypeTag oscTypeTag, const void* const source, const size_t numberOfElements);
+static int AddArray32AsBlob(OscMessage * const oscMessage, const void* const source, const size_t numberOfElements);
+static void CopyWordsBigEndian(void* const destination, const void* const source, const size_t numberOfWords);
+static int GetArray32(OscMessage * const oscMessage, const OscTypeTag oscTypeTag, void* const destination, const size_t maxNumberOfElements, size_t * const numberOfElements);
+static int GetArgumentSize(const OscMessage * const oscMessage, const int oscTypeTagStringIndex, const size_t argumentsIndex, size_t * const argumentSize);
 
 //------------------------------------------------------------------------------
 // Functions - Message construction
@@ -40,6 +46,32 @@ static int TerminateOscString(char* const oscString, size_t * const oscStringSiz
  * @return 0 if successful.
  */
 int OscMessageInitialise(OscMessage * const oscMessage, const char* oscAddressPattern) {
+    return OSC_MESSAGE_INITIALISE(oscMessage, oscAddressPattern);
+}
+
+/**
+ * @brief Initialises an OSC message structure with the specified storage.
+ *
+ * This function is used by OSC_MESSAGE_INITIALISE and should not be called
+ * directly by the user application.
+ *
+ * @param oscMessage Address of the OSC message to be initialised.
+ * @param oscTypeTagString Storage for the OSC type tag string.  Must be of
+ * size maxNumberOfArguments + 2.
+ * @param argumentIndexes Storage for the argument indexes.  Must be of size
+ * maxNumberOfArguments + 2.
+ * @param maxNumberOfArguments Maximum number of arguments.
+ * @param arguments Storage for the arguments.
+ * @param maxArgumentsSize Size of the argument storage.
+ * @param oscAddressPattern OSC address pattern as null terminated string.
+ * @return 0 if successful.
+ */
+int OscMessageInitialiseWithStorage(OscMessage * const oscMessage, char* const oscTypeTagString, uint16_t * const argumentIndexes, const size_t maxNumberOfArguments, char* const arguments, const size_t maxArgumentsSize, const char* oscAddressPattern) {
+    oscMessage->oscTypeTagString = oscTypeTagString;
+    oscMessage->arguments = arguments;
+    oscMessage->argumentIndexes = argumentIndexes;
+    oscMessage->maxNumberOfArguments = maxNumberOfArguments;
+    oscMessage->maxArgumentsSize = maxArgumentsSize;
     oscMessage->oscAddressPattern[0] = '\0'; // null terminate string
     oscMessage->oscTypeTagString[0] = ',';
     oscMessage->oscTypeTagString[1] = '\0'; // null terminate string
@@ -122,10 +154,10 @@ int OscMessageAppendAddressPattern(OscMessage * const oscMessage, const char* ap
  * @return 0 if successful.
  */
 int OscMessageAddInt32(OscMessage * const oscMessage, const int32_t int32) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument32) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagInt32;
@@ -152,10 +184,10 @@ int OscMessageAddInt32(OscMessage * const oscMessage, const int32_t int32) {
  * @return 0 if successful.
  */
 int OscMessageAddFloat32(OscMessage * const oscMessage, const float float32) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument32) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagFloat32;
@@ -182,17 +214,17 @@ int OscMessageAddFloat32(OscMessage * const oscMessage, const float float32) {
  * @return 0 if successful.
  */
 int OscMessageAddString(OscMessage * const oscMessage, const char * string) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
     size_t argumentsSize = oscMessage->argumentsSize; // local copy in case function returns error
     while (*string != '\0') {
-        if (argumentsSize >= MAX_ARGUMENTS_SIZE) {
+        if (argumentsSize >= oscMessage->maxArgumentsSize) {
             return 1; // error: message full
         }
         oscMessage->arguments[argumentsSize++] = *string++;
     }
-    if (TerminateOscString(oscMessage->arguments, &argumentsSize, MAX_ARGUMENTS_SIZE)) {
+    if (TerminateOscString(oscMessage->arguments, &argumentsSize, oscMessage->maxArgumentsSize)) {
         return 1; // error: message full
     }
     oscMessage->argumentsSize = argumentsSize;
@@ -217,10 +249,10 @@ int OscMessageAddString(OscMessage * const oscMessage, const char * string) {
  * @return 0 if successful.
  */
 int OscMessageAddBlob(OscMessage * const oscMessage, const char* const source, const size_t sourceSize) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument32) + sourceSize > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) + sourceSize > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     size_t argumentsSize = oscMessage->argumentsSize; // local copy in case function returns error
@@ -235,7 +267,7 @@ int OscMessageAddBlob(OscMessage * const oscMessage, const char* const source, c
         oscMessage->arguments[argumentsSize++] = source[sourceIndex];
     }
     while (argumentsSize % 4 != 0) {
-        if (argumentsSize >= MAX_ARGUMENTS_SIZE) {
+        if (argumentsSize >= oscMessage->maxArgumentsSize) {
             return 1; // error: message full
         }
         oscMessage->arguments[argumentsSize++] = 0;
@@ -259,10 +291,10 @@ int OscMessageAddBlob(OscMessage * const oscMessage, const char* const source, c
  * @return 0 if successful.
  */
 int OscMessageAddInt64(OscMessage * const oscMessage, const uint64_t int64) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument64) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument64) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagInt64;
@@ -293,10 +325,10 @@ int OscMessageAddInt64(OscMessage * const oscMessage, const uint64_t int64) {
  * @return 0 if successful.
  */
 int OscMessageAddTimeTag(OscMessage * const oscMessage, const OscTimeTag oscTimeTag) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscTimeTag) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscTimeTag) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[(oscMessage->oscTypeTagStringLength)++] = OscTypeTagTimeTag;
@@ -325,10 +357,10 @@ int OscMessageAddTimeTag(OscMessage * const oscMessage, const OscTimeTag oscTime
  * @return 0 if successful.
  */
 int OscMessageAddDouble(OscMessage * const oscMessage, const Double64 double64) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument64) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument64) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagDouble;
@@ -380,10 +412,10 @@ int OscMessageAddAlternateString(OscMessage * const oscMessage, const char* stri
  * @return 0 if successful.
  */
 int OscMessageAddCharacter(OscMessage * const oscMessage, const char asciiChar) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument32) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagCharacter;
@@ -410,10 +442,10 @@ int OscMessageAddCharacter(OscMessage * const oscMessage, const char asciiChar)
  * @return 0 if successful.
  */
 int OscMessageAddRgbaColour(OscMessage * const oscMessage, const RgbaColour rgbaColour) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument32) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagRgbaColour;
@@ -442,10 +474,10 @@ int OscMessageAddRgbaColour(OscMessage * const oscMessage, const RgbaColour rgba
  * @return 0 if successful.
  */
 int OscMessageAddMidiMessage(OscMessage * const oscMessage, const MidiMessage midiMessage) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
-    if (oscMessage->argumentsSize + sizeof (OscArgument32) > MAX_ARGUMENTS_SIZE) {
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) > oscMessage->maxArgumentsSize) {
         return 1; // error: message full
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagMidiMessage;
@@ -472,7 +504,7 @@ int OscMessageAddMidiMessage(OscMessage * const oscMessage, const MidiMessage mi
  * @return 0 if successful.
  */
 int OscMessageAddBool(OscMessage * const oscMessage, const bool boolean) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = boolean ? OscTypeTagTrue : OscTypeTagFalse;
@@ -492,7 +524,7 @@ int OscMessageAddBool(OscMessage * const oscMessage, const bool boolean) {
  * @return 0 if successful.
  */
 int OscMessageAddNil(OscMessage * const oscMessage) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagNil;
@@ -512,7 +544,7 @@ int OscMessageAddNil(OscMessage * const oscMessage) {
  * @return 0 if successful.
  */
 int OscMessageAddInfinitum(OscMessage * const oscMessage) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagInfinitum;
@@ -532,7 +564,7 @@ int OscMessageAddInfinitum(OscMessage * const oscMessage) {
  * @return 0 if successful.
  */
 int OscMessageAddBeginArray(OscMessage * const oscMessage) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagBeginArray;
@@ -552,7 +584,7 @@ int OscMessageAddBeginArray(OscMessage * const oscMessage) {
  * @return 0 if successful.
  */
 int OscMessageAddEndArray(OscMessage * const oscMessage) {
-    if (oscMessage->oscTypeTagStringLength > MAX_NUMBER_OF_ARGUMENTS) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
         return 1; // error: too many arguments
     }
     oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagEndArray;
@@ -560,6 +592,97 @@ int OscMessageAddEndArray(OscMessage * const oscMessage) {
     return 0;
 }
 
+/**
+ * @brief Adds an array of 32-bit integers to an OSC message as an OSC array.
+ *
+ * Each element is added as an int32 argument enclosed by 'begin array' and
+ * 'end array' type tags.  Each element occupies a character of the OSC type tag
+ * string and so the number of elements is limited by the maximum number of
+ * arguments.  OscMessageAddInt32ArrayAsBlob should be used for larger arrays.
+ *
+ * Example use:
+ * @code
+ * const int32_t source[] = { 1, 2, 3 };
+ * OscMessageAddInt32Array(&oscMessage, source, sizeof(source) / sizeof(int32_t));
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param source Address of the array of 32-bit integers.
+ * @param numberOfElements Number of elements in the array.
+ * @return 0 if successful.
+ */
+int OscMessageAddInt32Array(OscMessage * const oscMessage, const int32_t* const source, const size_t numberOfElements) {
+    return AddArray32(oscMessage, OscTypeTagInt32, source, numberOfElements);
+}
+
+/**
+ * @brief Adds an array of 32-bit floats to an OSC message as an OSC array.
+ *
+ * Each element is added as a float32 argument enclosed by 'begin array' and
+ * 'end array' type tags.  Each element occupies a character of the OSC type tag
+ * string and so the number of elements is limited by the maximum number of
+ * arguments.  OscMessageAddFloat32ArrayAsBlob should be used for larger arrays.
+ *
+ * Example use:
+ * @code
+ * const float source[] = { 1.0f, 2.0f, 3.0f };
+ * OscMessageAddFloat32Array(&oscMessage, source, sizeof(source) / sizeof(float));
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param source Address of the array of 32-bit floats.
+ * @param numberOfElements Number of elements in the array.
+ * @return 0 if successful.
+ */
+int OscMessageAddFloat32Array(OscMessage * const oscMessage, const float* const source, const size_t numberOfElements) {
+    return AddArray32(oscMessage, OscTypeTagFloat32, source, numberOfElements);
+}
+
+/**
+ * @brief Adds an array of 32-bit integers to an OSC message as a blob
+ * argument.
+ *
+ * Each element is written as a big-endian 32-bit word within a single blob
+ * argument.  The array therefore occupies a single character of the OSC type
+ * tag string regardless of the number of elements.
+ *
+ * Example use:
+ * @code
+ * const int32_t source[] = { 1, 2, 3 };
+ * OscMessageAddInt32ArrayAsBlob(&oscMessage, source, sizeof(source) / sizeof(int32_t));
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param source Address of the array of 32-bit integers.
+ * @param numberOfElements Number of elements in the array.
+ * @return 0 if successful.
+ */
+int OscMessageAddInt32ArrayAsBlob(OscMessage * const oscMessage, const int32_t* const source, const size_t numberOfElements) {
+    return AddArray32AsBlob(oscMessage, source, numberOfElements);
+}
+
+/**
+ * @brief Adds an array of 32-bit floats to an OSC message as a blob argument.
+ *
+ * Each element is written as a big-endian 32-bit word within a single blob
+ * argument.  The array therefore occupies a single character of the OSC type
+ * tag string regardless of the number of elements.
+ *
+ * Example use:
+ * @code
+ * const float source[] = { 1.0f, 2.0f, 3.0f };
+ * OscMessageAddFloat32ArrayAsBlob(&oscMessage, source, sizeof(source) / sizeof(float));
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param source Address of the array of 32-bit floats.
+ * @param numberOfElements Number of elements in the array.
+ * @return 0 if successful.
+ */
+int OscMessageAddFloat32ArrayAsBlob(OscMessage * const oscMessage, const float* const source, const size_t numberOfElements) {
+    return AddArray32AsBlob(oscMessage, source, numberOfElements);
+}
+
 /**
  * @brief Returns the size (number of bytes) of an OSC message.
  *
@@ -670,6 +793,86 @@ static int TerminateOscString(char* const oscString, size_t * const oscStringSiz
     return 0;
 }
 
+/**
+ * @brief Adds an array of 32-bit arguments to an OSC message as an OSC array.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param oscTypeTag OSC type tag of each element.
+ * @param source Address of the array.
+ * @param numberOfElements Number of elements in the array.
+ * @return 0 if successful.
+ */
+static int AddArray32(OscMessage * const oscMessage, const OscTypeTag oscTypeTag, const void* const source, const size_t numberOfElements) {
+    if (oscMessage->oscTypeTagStringLength + numberOfElements + 2 > (1 + oscMessage->maxNumberOfArguments)) {
+        return 1; // error: too many arguments
+    }
+    if (oscMessage->argumentsSize + (numberOfElements * sizeof (OscArgument32)) > oscMessage->maxArgumentsSize) {
+        return 1; // error: message full
+    }
+    oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagBeginArray;
+    memset(&oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength], oscTypeTag, numberOfElements);
+    oscMessage->oscTypeTagStringLength += numberOfElements;
+    oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagEndArray;
+    oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength] = '\0'; // null terminate string
+    CopyWordsBigEndian(&oscMessage->arguments[oscMessage->argumentsSize], source, numberOfElements);
+    oscMessage->argumentsSize += numberOfElements * sizeof (OscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Adds an array of 32-bit words to an OSC message as a blob argument.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param source Address of the array.
+ * @param numberOfElements Number of elements in the array.
+ * @return 0 if successful.
+ */
+static int AddArray32AsBlob(OscMessage * const oscMessage, const void* const source, const size_t numberOfElements) {
+    if (oscMessage->oscTypeTagStringLength > oscMessage->maxNumberOfArguments) {
+        return 1; // error: too many arguments
+    }
+    if (oscMessage->argumentsSize + sizeof (OscArgument32) + (numberOfElements * sizeof (OscArgument32)) > oscMessage->maxArgumentsSize) {
+        return 1; // error: message full
+    }
+    const uint32_t blobSize = numberOfElements * sizeof (OscArgument32);
+    CopyWordsBigEndian(&oscMessage->arguments[oscMessage->argumentsSize], &blobSize, 1);
+    oscMessage->argumentsSize += sizeof (OscArgument32);
+    CopyWordsBigEndian(&oscMessage->arguments[oscMessage->argumentsSize], source, numberOfElements);
+    oscMessage->argumentsSize += blobSize; // no padding required
+    oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength++] = OscTypeTagBlob;
+    oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength] = '\0'; // null terminate string
+    return 0;
+}
+
+/**
+ * @brief Copies 32-bit words while converting between host byte order and
+ * big-endian byte order.  Each word is converted by a single byte swap rather
+ * than by individual byte assignments.  The conversion is symmetric and so this
+ * function is used for both construction and deconstruction.  Neither the
+ * destination nor the source are required to be word-aligned.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param destination Destination address.
+ * @param source Source address.
+ * @param numberOfWords Number of 32-bit words to copy.
+ */
+static void CopyWordsBigEndian(void* const destination, const void* const source, const size_t numberOfWords) {
+    char* const destinationBytes = destination;
+    const char* const sourceBytes = source;
+    size_t index;
+    for (index = 0; index < (numberOfWords * sizeof (uint32_t)); index += sizeof (uint32_t)) {
+        uint32_t word;
+        memcpy(&word, &sourceBytes[index], sizeof (uint32_t));
+        word = OSC_BIG_ENDIAN_32(word);
+        memcpy(&destinationBytes[index], &word, sizeof (uint32_t));
+    }
+}
+
 //------------------------------------------------------------------------------
 // Functions - Message deconstruction
 
@@ -678,7 +881,9 @@ static int TerminateOscString(char* const oscString, size_t * const oscStringSiz
  * packet or OSC bundle.
  *
  * This function is used internally and should not be used by the user
- * application.
+ * application.  The OSC message must have been initialised using either
+ * OscMessageInitialise or OSC_MESSAGE_INITIALISE so that the storage and
+ * capacity of the OSC message type are retained.
  *
  * @param oscMessage Address of the OSC message structure.
  * @param source Address of the char array.
@@ -686,7 +891,7 @@ static int TerminateOscString(char* const oscString, size_t * const oscStringSiz
  * @return 0 if successful.
  */
 int OscMessageInitialiseFromCharArray(OscMessage * const oscMessage, const char* const source, const size_t sourceSize) {
-    OscMessageInitialise(oscMessage, "");
+    OscMessageInitialiseWithStorage(oscMessage, oscMessage->oscTypeTagString, oscMessage->argumentIndexes, oscMessage->maxNumberOfArguments, oscMessage->arguments, oscMessage->maxArgumentsSize, "");
 
     // Return error if not valid OSC message
     if (sourceSize % 4 != 0) {
@@ -725,7 +930,7 @@ int OscMessageInitialiseFromCharArray(OscMessage * const oscMessage, const char*
     // OSC type tag string
     while (source[sourceIndex] != '\0') {
         oscMessage->oscTypeTagString[oscMessage->oscTypeTagStringLength] = source[sourceIndex];
-        if (++oscMessage->oscTypeTagStringLength > MAX_OSC_TYPE_TAG_STRING_LENGTH) {
+        if (++oscMessage->oscTypeTagStringLength > (1 + oscMessage->maxNumberOfArguments)) {
             return 1; // error: type tag string too long
         }
         if (++sourceIndex >= sourceSize) {
@@ -742,10 +947,25 @@ int OscMessageInitialiseFromCharArray(OscMessage * const oscMessage, const char*
     } while (sourceIndex % 4 != 0);
 
     // Arguments
+    if ((sourceSize - sourceIndex) > oscMessage->maxArgumentsSize) {
+        return 1; // error: arguments too large
+    }
     while (sourceIndex < sourceSize) {
         oscMessage->arguments[oscMessage->argumentsSize++] = source[sourceIndex++];
     }
 
+    // Index arguments
+    size_t argumentsIndex = 0;
+    int oscTypeTagStringIndex;
+    for (oscTypeTagStringIndex = 1; oscTypeTagStringIndex < oscMessage->oscTypeTagStringLength; oscTypeTagStringIndex++) {
+        oscMessage->argumentIndexes[oscTypeTagStringIndex] = argumentsIndex;
+        size_t argumentSize;
+        if (GetArgumentSize(oscMessage, oscTypeTagStringIndex, argumentsIndex, &argumentSize) != 0) {
+            return 1; // error: invalid argument
+        }
+        argumentsIndex += argumentSize;
+    }
+    oscMessage->argumentIndexes[oscTypeTagStringIndex] = argumentsIndex;
     return 0;
 }
 
@@ -793,9 +1013,9 @@ OscTypeTag OscMessageGetArgumentType(OscMessage * const oscMessage) {
  * @brief Skips the next argument available within an OSC message indicated by the
  * current oscTypeTagStringIndex value.
  *
- * A null character (value zero) will be returned if no arguments are available.
- * oscTypeTagStringIndex will be incremented to the next OSC bundle element if
- * this function is successful.
+ * Both oscTypeTagStringIndex and argumentsIndex will be advanced to the next
+ * argument if this function is successful so that the following argument may be
+ * read directly.
  *
  * Example use:
  * @code
@@ -813,13 +1033,50 @@ OscTypeTag OscMessageGetArgumentType(OscMessage * const oscMessage) {
  * @return 0 if successful.
  */
 int OscMessageSkipArgument(OscMessage * const oscMessage) {
-    if (oscMessage->oscTypeTagStringIndex > oscMessage->oscTypeTagStringLength) {
+    if (oscMessage->oscTypeTagStringIndex >= oscMessage->oscTypeTagStringLength) {
         return 1; // error: end of type tag string
     }
+    size_t argumentSize;
+    if (GetArgumentSize(oscMessage, oscMessage->oscTypeTagStringIndex, oscMessage->argumentsIndex, &argumentSize) != 0) {
+        return 1; // error: invalid argument
+    }
+    oscMessage->argumentsIndex += argumentSize;
     oscMessage->oscTypeTagStringIndex++;
     return 0;
 }
 
+/**
+ * @brief Selects the argument at the specified position as the next argument
+ * available within an OSC message.
+ *
+ * The position of each argument is indexed once by
+ * OscMessageInitialiseFromCharArray and so any argument may be selected in
+ * constant time without decoding the preceding arguments.  Each character of
+ * the OSC type tag string (excluding the comma) is an argument position,
+ * including 'begin array' and 'end array'.  This function may only be used with
+ * an OSC message initialised using OscMessageInitialiseFromCharArray.
+ *
+ * Example use:
+ * @code
+ * int32_t int32;
+ * if (OscMessageSelectArgument(&oscMessage, 5) == 0) {
+ *     OscMessageGetInt32(&oscMessage, &int32);
+ * }
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param argumentNumber Position of the argument, starting from 0.
+ * @return 0 if successful.
+ */
+int OscMessageSelectArgument(OscMessage * const oscMessage, const int argumentNumber) {
+    if ((argumentNumber < 0) || ((argumentNumber + 1) >= oscMessage->oscTypeTagStringLength)) {
+        return 1; // error: argument does not exist
+    }
+    oscMessage->oscTypeTagStringIndex = argumentNumber + 1; // skip comma
+    oscMessage->argumentsIndex = oscMessage->argumentIndexes[oscMessage->oscTypeTagStringIndex];
+    return 0;
+}
+
 /**
  * @brief Gets a 32-bit integer argument from an OSC message.
  *
@@ -1333,5 +1590,189 @@ int OscMessageGetMidiMessage(OscMessage * const oscMessage, MidiMessage * const
     return 0;
 }
 
+/**
+ * @brief Gets an array of 32-bit integers from an OSC message.
+ *
+ * The next argument available within the OSC message must be either an OSC
+ * array containing only int32 arguments, or a blob created by
+ * OscMessageAddInt32ArrayAsBlob, else this function will return an error.  The
+ * internal index, oscTypeTagStringIndex, will only be incremented past the
+ * array if this function is successful.
+ *
+ * Example use:
+ * @code
+ * int32_t int32Array[16];
+ * size_t numberOfElements;
+ * OscMessageGetInt32Array(&oscMessage, int32Array, sizeof(int32Array) / sizeof(int32_t), &numberOfElements);
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param destination Address where the array will be written.
+ * @param maxNumberOfElements Maximum number of elements that the destination
+ * can contain.
+ * @param numberOfElements Address where the number of elements will be
+ * written.
+ * @return 0 if successful.
+ */
+int OscMessageGetInt32Array(OscMessage * const oscMessage, int32_t* const destination, const size_t maxNumberOfElements, size_t * const numberOfElements) {
+    return GetArray32(oscMessage, OscTypeTagInt32, destination, maxNumberOfElements, numberOfElements);
+}
+
+/**
+ * @brief Gets an array of 32-bit floats from an OSC message.
+ *
+ * The next argument available within the OSC message must be either an OSC
+ * array containing only float32 arguments, or a blob created by
+ * OscMessageAddFloat32ArrayAsBlob, else this function will return an error.
+ * The internal index, oscTypeTagStringIndex, will only be incremented past the
+ * array if this function is successful.
+ *
+ * Example use:
+ * @code
+ * float float32Array[16];
+ * size_t numberOfElements;
+ * OscMessageGetFloat32Array(&oscMessage, float32Array, sizeof(float32Array) / sizeof(float), &numberOfElements);
+ * @endcode
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param destination Address where the array will be written.
+ * @param maxNumberOfElements Maximum number of elements that the destination
+ * can contain.
+ * @param numberOfElements Address where the number of elements will be
+ * written.
+ * @return 0 if successful.
+ */
+int OscMessageGetFloat32Array(OscMessage * const oscMessage, float* const destination, const size_t maxNumberOfElements, size_t * const numberOfElements) {
+    return GetArray32(oscMessage, OscTypeTagFloat32, destination, maxNumberOfElements, numberOfElements);
+}
+
+/**
+ * @brief Gets an array of 32-bit arguments from an OSC message.  The array
+ * may be either an OSC array of the specified type or a blob.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param oscTypeTag OSC type tag of each element within an OSC array.
+ * @param destination Address where the array will be written.
+ * @param maxNumberOfElements Maximum number of elements that the destination
+ * can contain.
+ * @param numberOfElements Address where the number of elements will be
+ * written.
+ * @return 0 if successful.
+ */
+static int GetArray32(OscMessage * const oscMessage, const OscTypeTag oscTypeTag, void* const destination, const size_t maxNumberOfElements, size_t * const numberOfElements) {
+    int oscTypeTagStringIndex = oscMessage->oscTypeTagStringIndex;
+    size_t argumentsIndex = oscMessage->argumentsIndex;
+    size_t arraySize;
+    switch (oscMessage->oscTypeTagString[oscTypeTagStringIndex++]) {
+        case OscTypeTagBeginArray:
+            arraySize = 0;
+            while (oscMessage->oscTypeTagString[oscTypeTagStringIndex] == oscTypeTag) {
+                oscTypeTagStringIndex++;
+                arraySize += sizeof (OscArgument32);
+            }
+            if (oscMessage->oscTypeTagString[oscTypeTagStringIndex++] != OscTypeTagEndArray) {
+                return 1; // error: unexpected argument type
+            }
+            break;
+        case OscTypeTagBlob:
+        {
+            if (argumentsIndex + sizeof (OscArgument32) > oscMessage->argumentsSize) {
+                return 1; // error: message too short to contain argument
+            }
+            uint32_t blobSize;
+            CopyWordsBigEndian(&blobSize, &oscMessage->arguments[argumentsIndex], 1);
+            argumentsIndex += sizeof (OscArgument32);
+            if ((blobSize % sizeof (OscArgument32)) != 0) {
+                return 1; // error: blob does not contain 32-bit words
+            }
+            arraySize = blobSize;
+            break;
+        }
+        default:
+            return 1; // error: unexpected argument type
+    }
+    if (arraySize > (maxNumberOfElements * sizeof (OscArgument32))) {
+        return 1; // error: destination too small
+    }
+    if (argumentsIndex + arraySize > oscMessage->argumentsSize) {
+        return 1; // error: message too short to contain argument
+    }
+    CopyWordsBigEndian(destination, &oscMessage->arguments[argumentsIndex], arraySize / sizeof (OscArgument32));
+    *numberOfElements = arraySize / sizeof (OscArgument32);
+    oscMessage->argumentsIndex = argumentsIndex + arraySize;
+    oscMessage->oscTypeTagStringIndex = oscTypeTagStringIndex;
+    return 0;
+}
+
+/**
+ * @brief Gets the size (number of bytes) of an argument.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessage Address of the OSC message structure.
+ * @param oscTypeTagStringIndex Index of the OSC type tag of the argument.
+ * @param argumentsIndex Index of the first byte of the argument.
+ * @param argumentSize Address where the argument size will be written.
+ * @return 0 if successful.
+ */
+static int GetArgumentSize(const OscMessage * const oscMessage, const int oscTypeTagStringIndex, const size_t argumentsIndex, size_t * const argumentSize) {
+    const size_t maxArgumentSize = oscMessage->argumentsSize - argumentsIndex;
+    switch (oscMessage->oscTypeTagString[oscTypeTagStringIndex]) {
+        case OscTypeTagInt32:
+        case OscTypeTagFloat32:
+        case OscTypeTagCharacter:
+        case OscTypeTagRgbaColour:
+        case OscTypeTagMidiMessage:
+            *argumentSize = sizeof (OscArgument32);
+            break;
+        case OscTypeTagInt64:
+        case OscTypeTagTimeTag:
+        case OscTypeTagDouble:
+            *argumentSize = sizeof (OscArgument64);
+            break;
+        case OscTypeTagString:
+        case OscTypeTagAlternateString:
+            *argumentSize = 0;
+            do {
+                if (*argumentSize >= maxArgumentSize) {
+                    return 1; // error: string not terminated
+                }
+            } while (oscMessage->arguments[argumentsIndex + (*argumentSize)++] != '\0');
+            break;
+        case OscTypeTagBlob:
+        {
+            if (sizeof (OscArgument32) > maxArgumentSize) {
+                return 1; // error: message too short to contain argument
+            }
+            int32_t blobSize;
+            CopyWordsBigEndian(&blobSize, &oscMessage->arguments[argumentsIndex], 1);
+            if (blobSize < 0) {
+                return 1; // error: size cannot be negative
+            }
+            *argumentSize = sizeof (OscArgument32) + (size_t) blobSize;
+            break;
+        }
+        case OscTypeTagTrue:
+        case OscTypeTagFalse:
+        case OscTypeTagNil:
+        case OscTypeTagInfinitum:
+        case OscTypeTagBeginArray:
+        case OscTypeTagEndArray:
+            *argumentSize = 0;
+            break;
+        default:
+            return 1; // error: unknown argument type
+    }
+    if (*argumentSize % 4 != 0) {
+        *argumentSize += 4 - *argumentSize % 4; // increase to multiple of 4
+    }
+    if (*argumentSize > maxArgumentSize) {
+        return 1; // error: message too short to contain argument
+    }
+    return 0;
+}
+
 //------------------------------------------------------------------------------
 // End of file
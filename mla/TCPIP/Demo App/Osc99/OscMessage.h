@@ -5,7 +5,8 @@
  * messages.
  *
  * MAX_OSC_ADDRESS_PATTERN_LENGTH and MAX_NUMBER_OF_ARGUMENTS may be modified as
- * required by the user application.
+ * required by the user application.  OSC message types of a smaller capacity
+ * may be defined using OSC_MESSAGE_TYPE.
  *
  * @see http://opensoundcontrol.org/spec-1_0
  */
@@ -19,7 +20,7 @@
 #include "OscCommon.h"
 #include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t, NULL
-#include <stdint.h> // int32_t, int64_t
+#include <stdint.h> // int32_t, int64_t, uint16_t
 
 //------------------------------------------------------------------------------
 // Definitions
@@ -65,19 +66,67 @@
 #define MAX_ARGUMENTS_SIZE (MAX_OSC_MESSAGE_SIZE - (MAX_OSC_ADDRESS_PATTERN_LENGTH + 4) - (MAX_OSC_TYPE_TAG_STRING_LENGTH + 4))
 
 /**
- * @brief OSC bundle structure.  Must be initialised using either
- * OscMessageInitialise or OscMessageInitialiseFromCharArray.
+ * @brief Members common to every OSC message type.  The oscTypeTagString,
+ * arguments and argumentIndexes members point to the storage of the containing
+ * type and the capacity of that storage is held by the maxNumberOfArguments and
+ * maxArgumentsSize members.  All OSC message functions access the storage only
+ * through these members and so accept any OSC message type.  An OSC message
+ * must therefore not be copied by assignment.
  */
-typedef struct {
-    char oscAddressPattern[MAX_OSC_ADDRESS_PATTERN_LENGTH + 1]; // null terminated, must be first member so that first byte of structure is equal to '/'.
-    char oscTypeTagString[MAX_OSC_TYPE_TAG_STRING_LENGTH + 1]; // includes comma, null terminated
-    char arguments[MAX_ARGUMENTS_SIZE];
-    size_t oscAddressPatternLength; // does not include null characters
-    size_t oscTypeTagStringLength; // includes comma but not null characters
-    size_t argumentsSize;
-    int oscTypeTagStringIndex;
+#define OSC_MESSAGE_HEADER \
+    char oscAddressPattern[MAX_OSC_ADDRESS_PATTERN_LENGTH + 1]; /* null terminated, must be first member so that first byte of structure is equal to '/'. */ \
+    char* oscTypeTagString; /* includes comma, null terminated */ \
+    char* arguments; \
+    uint16_t* argumentIndexes; /* index of each argument within arguments, indexed by OSC type tag string index */ \
+    size_t maxNumberOfArguments; \
+    size_t maxArgumentsSize; \
+    size_t oscAddressPatternLength; /* does not include null characters */ \
+    size_t oscTypeTagStringLength; /* includes comma but not null characters */ \
+    size_t argumentsSize; \
+    int oscTypeTagStringIndex; \
     int argumentsIndex;
-} OscMessage;
+
+/**
+ * @brief Macro that defines an OSC message type of the specified capacity.  An
+ * OSC message type must be initialised using OSC_MESSAGE_INITIALISE and passed
+ * to OSC message functions using OSC_MESSAGE.  A small OSC message type may be
+ * used where the default capacity of OscMessage would waste RAM, for example,
+ * when queuing many OSC messages.
+ *
+ * Example use:
+ * @code
+ * OSC_MESSAGE_TYPE(TimeTagMessage, 1, sizeof(OscTimeTag));
+ * TimeTagMessage timeTagMessage;
+ * OSC_MESSAGE_INITIALISE(&timeTagMessage, "/example");
+ * OscMessageAddTimeTag(OSC_MESSAGE(&timeTagMessage), OSC_TIME_TAG_ZERO);
+ * @endcode
+ */
+#define OSC_MESSAGE_TYPE(name, maxNumberOfArguments_, maxArgumentsSize_) \
+    typedef struct { \
+        OSC_MESSAGE_HEADER \
+        char oscTypeTagStringStorage[(maxNumberOfArguments_) + 2]; \
+        uint16_t argumentIndexesStorage[(maxNumberOfArguments_) + 2]; \
+        char argumentsStorage[maxArgumentsSize_]; \
+    } name
+
+/**
+ * @brief Macro that resolves as the address of an OSC message type defined
+ * using OSC_MESSAGE_TYPE as an OscMessage pointer.
+ */
+#define OSC_MESSAGE(oscMessageType) ((OscMessage*) (oscMessageType))
+
+/**
+ * @brief Macro that initialises an OSC message type defined using
+ * OSC_MESSAGE_TYPE.  Equivalent to OscMessageInitialise.
+ */
+#define OSC_MESSAGE_INITIALISE(oscMessageType, oscAddressPattern) \
+    OscMessageInitialiseWithStorage(OSC_MESSAGE(oscMessageType), (oscMessageType)->oscTypeTagStringStorage, (oscMessageType)->argumentIndexesStorage, sizeof ((oscMessageType)->oscTypeTagStringStorage) - 2, (oscMessageType)->argumentsStorage, sizeof ((oscMessageType)->argumentsStorage), (oscAddressPattern))
+
+/**
+ * @brief OSC message structure of the default capacity.  Must be initialised
+ * using OscMessageInitialise before use with OscMessageInitialiseFromCharArray.
+ */
+OSC_MESSAGE_TYPE(OscMessage, MAX_NUMBER_OF_ARGUMENTS, MAX_ARGUMENTS_SIZE);
 
 /**
  * @brief OSC type tag string characters indicating argument type.
@@ -107,6 +156,7 @@ typedef enum {
 
 // Message construction
 int OscMessageInitialise(OscMessage * const oscMessage, const char* oscAddressPattern);
+int OscMessageInitialiseWithStorage(OscMessage * const oscMessage, char* const oscTypeTagString, uint16_t * const argumentIndexes, const size_t maxNumberOfArguments, char* const arguments, const size_t maxArgumentsSize, const char* oscAddressPattern);
 int OscMessageSetAddressPattern(OscMessage * const oscMessage, const char* oscAddressPattern);
 int OscMessageAppendAddressPattern(OscMessage * const oscMessage, const char* appendedParts);
 int OscMessageAddInt32(OscMessage * const oscMessage, const int32_t int32);
@@ -125,6 +175,10 @@ int OscMessageAddNil(OscMessage * const oscMessage);
 int OscMessageAddInfinitum(OscMessage * const oscMessage);
 int OscMessageAddBeginArray(OscMessage * const oscMessage);
 int OscMessageAddEndArray(OscMessage * const oscMessage);
+int OscMessageAddInt32Array(OscMessage * const oscMessage, const int32_t* const source, const size_t numberOfElements);
+int OscMessageAddFloat32Array(OscMessage * const oscMessage, const float* const source, const size_t numberOfElements);
+int OscMessageAddInt32ArrayAsBlob(OscMessage * const oscMessage, const int32_t* const source, const size_t numberOfElements);
+int OscMessageAddFloat32ArrayAsBlob(OscMessage * const oscMessage, const float* const source, const size_t numberOfElements);
 size_t OscMessageGetSize(const OscMessage * const oscMessage);
 int OscMessageToCharArray(const OscMessage * const oscMessage, size_t * const oscMessageSize, char* const destination, const size_t destinationSize);
 
@@ -133,6 +187,7 @@ int OscMessageInitialiseFromCharArray(OscMessage * const oscMessage, const char*
 bool OscMessageIsArgumentAvailable(OscMessage * const oscMessage);
 OscTypeTag OscMessageGetArgumentType(OscMessage * const oscMessage);
 int OscMessageSkipArgument(OscMessage * const oscMessage);
+int OscMessageSelectArgument(OscMessage * const oscMessage, const int argumentNumber);
 int OscMessageGetInt32(OscMessage * const oscMessage, int32_t * const int32);
 int OscMessageGetFloat32(OscMessage * const oscMessage, float * const float32);
 int OscMessageGetString(OscMessage * const oscMessage, char* const destination, const size_t destinationSize);
@@ -143,6 +198,8 @@ int OscMessageGetDouble(OscMessage * const oscMessage, Double64 * const double64
 int OscMessageGetCharacter(OscMessage * const oscMessage, char* const character);
 int OscMessageGetRgbaColour(OscMessage * const oscMessage, RgbaColour * const rgbaColour);
 int OscMessageGetMidiMessage(OscMessage * const oscMessage, MidiMessage * const midiMessage);
+int OscMessageGetInt32Array(OscMessage * const oscMessage, int32_t* const destination, const size_t maxNumberOfElements, size_t * const numberOfElements);
+int OscMessageGetFloat32Array(OscMessage * const oscMessage, float* const destination, const size_t maxNumberOfElements, size_t * const numberOfElements);
 
 #endif
 
@@ -0,0 +1,326 @@
+/**
+ * @file OscMessageTemplate.c
+ * @author Seb Madgwick
+ * @brief Functions and structures for precompiled OSC messages with fixed-width
+ * arguments that may be modified in place.
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscMessageTemplate.h"
+#include "OscMessageWriter.h"
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static char* GetArgument(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const OscTypeTag oscTypeTag);
+static void WriteArgument32(char* const destination, const OscArgument32 oscArgument32);
+static void WriteArgument64(char* const destination, const OscArgument64 oscArgument64);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises an OSC message template.
+ *
+ * The OSC address pattern and OSC type tag string are written once and the
+ * index of each argument is stored.  All argument values are initialised to
+ * zero.  The OSC type tag string must only contain fixed-width argument types
+ * (strings and blobs are not permitted).
+ *
+ * Example use:
+ * @code
+ * OscMessageTemplate oscMessageTemplate;
+ * OscMessageTemplateInitialise(&oscMessageTemplate, "/example", ",it");
+ * OscMessageTemplateSetInt32(&oscMessageTemplate, 0, 123);
+ * OscMessageTemplateSetTimeTag(&oscMessageTemplate, 1, oscTimeTag);
+ * Send(oscMessageTemplate.contents, oscMessageTemplate.size);
+ * @endcode
+ *
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param oscAddressPattern OSC address pattern as null terminated string.
+ * @param oscTypeTagString OSC type tag string (including comma) as null
+ * terminated string.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateInitialise(OscMessageTemplate * const oscMessageTemplate, const char* oscAddressPattern, const char* oscTypeTagString) {
+    oscMessageTemplate->size = 0;
+    oscMessageTemplate->numberOfArguments = 0;
+
+    // OSC address pattern and OSC type tag string
+    OscMessageWriter oscMessageWriter;
+    if (OscMessageWriterInitialise(&oscMessageWriter, oscMessageTemplate->contents, sizeof (oscMessageTemplate->contents), oscAddressPattern, oscTypeTagString) != 0) {
+        return 1; // error: invalid OSC address pattern or OSC type tag string, or template full
+    }
+    oscMessageTemplate->oscTypeTagStringIndex = oscMessageWriter.oscTypeTagString - oscMessageTemplate->contents;
+
+    // Arguments
+    size_t size = oscMessageWriter.size;
+    const char* oscTypeTag = &oscTypeTagString[1]; // skip comma
+    while (*oscTypeTag != '\0') {
+        size_t argumentSize;
+        switch ((OscTypeTag) * oscTypeTag) {
+            case OscTypeTagInt32:
+            case OscTypeTagFloat32:
+            case OscTypeTagCharacter:
+            case OscTypeTagRgbaColour:
+            case OscTypeTagMidiMessage:
+                argumentSize = sizeof (OscArgument32);
+                break;
+            case OscTypeTagInt64:
+            case OscTypeTagTimeTag:
+            case OscTypeTagDouble:
+                argumentSize = sizeof (OscArgument64);
+                break;
+            case OscTypeTagTrue:
+            case OscTypeTagFalse:
+            case OscTypeTagNil:
+            case OscTypeTagInfinitum:
+            case OscTypeTagBeginArray:
+            case OscTypeTagEndArray:
+                argumentSize = 0;
+                break;
+            default:
+                return 1; // error: argument type not fixed-width
+        }
+        if (oscMessageTemplate->numberOfArguments >= MAX_OSC_MESSAGE_TEMPLATE_ARGUMENTS) {
+            return 1; // error: too many arguments
+        }
+        if (size + argumentSize > MAX_OSC_MESSAGE_TEMPLATE_SIZE) {
+            return 1; // error: template full
+        }
+        oscMessageTemplate->argumentIndexes[oscMessageTemplate->numberOfArguments++] = size;
+        while (argumentSize-- > 0) {
+            oscMessageTemplate->contents[size++] = 0;
+        }
+        oscTypeTag++;
+    }
+    oscMessageTemplate->size = size;
+    return 0;
+}
+
+/**
+ * @brief Sets a 32-bit integer argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param int32 32-bit integer value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetInt32(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const int32_t int32) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagInt32);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.int32 = int32;
+    WriteArgument32(argument, oscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Sets a 32-bit float argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param float32 32-bit float value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetFloat32(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const float float32) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagFloat32);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.float32 = float32;
+    WriteArgument32(argument, oscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Sets a 64-bit integer argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param int64 64-bit integer value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetInt64(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const uint64_t int64) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagInt64);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument64 oscArgument64;
+    oscArgument64.int64 = int64;
+    WriteArgument64(argument, oscArgument64);
+    return 0;
+}
+
+/**
+ * @brief Sets an OSC time tag argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param oscTimeTag OSC time tag value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetTimeTag(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const OscTimeTag oscTimeTag) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagTimeTag);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument64 oscArgument64;
+    oscArgument64.oscTimeTag = oscTimeTag;
+    WriteArgument64(argument, oscArgument64);
+    return 0;
+}
+
+/**
+ * @brief Sets a 64-bit double argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param double64 64-bit double value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetDouble(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const Double64 double64) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagDouble);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument64 oscArgument64;
+    oscArgument64.double64 = double64;
+    WriteArgument64(argument, oscArgument64);
+    return 0;
+}
+
+/**
+ * @brief Sets a character argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param asciiChar Character value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetCharacter(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const char asciiChar) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagCharacter);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    argument[3] = asciiChar;
+    return 0;
+}
+
+/**
+ * @brief Sets a 32-bit RGBA colour argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param rgbaColour 32-bit RGBA colour value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetRgbaColour(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const RgbaColour rgbaColour) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagRgbaColour);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.rgbaColour = rgbaColour;
+    WriteArgument32(argument, oscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Sets a 4 byte MIDI message argument within an OSC message template.
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param midiMessage 4 byte MIDI message value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetMidiMessage(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const MidiMessage midiMessage) {
+    char* const argument = GetArgument(oscMessageTemplate, argumentNumber, OscTypeTagMidiMessage);
+    if (argument == NULL) {
+        return 1; // error: invalid argument number or unexpected argument type
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.midiMessage = midiMessage;
+    WriteArgument32(argument, oscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Sets a boolean argument within an OSC message template.
+ *
+ * A boolean argument has no data and is represented only by its OSC type tag.
+ * The OSC type tag is therefore modified in place.  The argument must have
+ * been declared as either true or false.
+ *
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param boolean Boolean value.
+ * @return 0 if successful.
+ */
+int OscMessageTemplateSetBool(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const bool boolean) {
+    if (argumentNumber < 0 || argumentNumber >= oscMessageTemplate->numberOfArguments) {
+        return 1; // error: invalid argument number
+    }
+    char* const oscTypeTag = &oscMessageTemplate->contents[oscMessageTemplate->oscTypeTagStringIndex + 1 + argumentNumber];
+    if (*oscTypeTag != (char) OscTypeTagTrue && *oscTypeTag != (char) OscTypeTagFalse) {
+        return 1; // error: unexpected argument type
+    }
+    *oscTypeTag = (char) (boolean ? OscTypeTagTrue : OscTypeTagFalse);
+    return 0;
+}
+
+/**
+ * @brief Gets the address of an argument within an OSC message template.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessageTemplate Address of the OSC message template structure.
+ * @param argumentNumber Argument number, where 0 is the first argument.
+ * @param oscTypeTag Expected OSC type tag of the argument.
+ * @return Address of the first byte of the argument.  NULL if the argument
+ * number is invalid or the argument type is not as expected.
+ */
+static char* GetArgument(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const OscTypeTag oscTypeTag) {
+    if (argumentNumber < 0 || argumentNumber >= oscMessageTemplate->numberOfArguments) {
+        return NULL; // error: invalid argument number
+    }
+    if (oscMessageTemplate->contents[oscMessageTemplate->oscTypeTagStringIndex + 1 + argumentNumber] != (char) oscTypeTag) {
+        return NULL; // error: unexpected argument type
+    }
+    return &oscMessageTemplate->contents[oscMessageTemplate->argumentIndexes[argumentNumber]];
+}
+
+/**
+ * @brief Writes a 32-bit argument as big-endian.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param destination Address of the first byte of the argument.
+ * @param oscArgument32 32-bit argument.
+ */
+static void WriteArgument32(char* const destination, const OscArgument32 oscArgument32) {
+    destination[0] = oscArgument32.byteStruct.byte3;
+    destination[1] = oscArgument32.byteStruct.byte2;
+    destination[2] = oscArgument32.byteStruct.byte1;
+    destination[3] = oscArgument32.byteStruct.byte0;
+}
+
+/**
+ * @brief Writes a 64-bit argument as big-endian.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param destination Address of the first byte of the argument.
+ * @param oscArgument64 64-bit argument.
+ */
+static void WriteArgument64(char* const destination, const OscArgument64 oscArgument64) {
+    destination[0] = oscArgument64.byteStruct.byte7;
+    destination[1] = oscArgument64.byteStruct.byte6;
+    destination[2] = oscArgument64.byteStruct.byte5;
+    destination[3] = oscArgument64.byteStruct.byte4;
+    destination[4] = oscArgument64.byteStruct.byte3;
+    destination[5] = oscArgument64.byteStruct.byte2;
+    destination[6] = oscArgument64.byteStruct.byte1;
+    destination[7] = oscArgument64.byteStruct.byte0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,77 @@
+/**
+ * @file OscMessageTemplate.h
+ * @author Seb Madgwick
+ * @brief Functions and structures for precompiled OSC messages with fixed-width
+ * arguments that may be modified in place.
+ *
+ * An OSC message template is compiled once from an OSC address pattern and an
+ * OSC type tag string into a complete OSC message with known argument offsets.
+ * Individual arguments may then be set without rebuilding the message.  Only
+ * fixed-width argument types may be used so that the size of the message and
+ * the offset of each argument never change.
+ *
+ * MAX_OSC_MESSAGE_TEMPLATE_SIZE and MAX_OSC_MESSAGE_TEMPLATE_ARGUMENTS may be
+ * modified as required by the user application.
+ *
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+#ifndef OSC_MESSAGE_TEMPLATE_H
+#define OSC_MESSAGE_TEMPLATE_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscCommon.h"
+#include "OscMessage.h"
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t, NULL
+#include <stdint.h> // int32_t, uint64_t
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum size (number of bytes) of an OSC message template.  This value
+ * may be modified as required by the user application.
+ */
+#define MAX_OSC_MESSAGE_TEMPLATE_SIZE 64
+
+/**
+ * @brief Maximum number of arguments that may be contained within an OSC
+ * message template.  This value may be modified as required by the user
+ * application.
+ */
+#define MAX_OSC_MESSAGE_TEMPLATE_ARGUMENTS 8
+
+/**
+ * @brief OSC message template structure.  Must be initialised using
+ * OscMessageTemplateInitialise.  The contents member is a complete OSC message
+ * of the size indicated by the size member.
+ */
+typedef struct {
+    char contents[MAX_OSC_MESSAGE_TEMPLATE_SIZE];
+    size_t size;
+    size_t oscTypeTagStringIndex; // index of comma within contents
+    size_t argumentIndexes[MAX_OSC_MESSAGE_TEMPLATE_ARGUMENTS]; // index of each argument within contents
+    int numberOfArguments;
+} OscMessageTemplate;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+int OscMessageTemplateInitialise(OscMessageTemplate * const oscMessageTemplate, const char* oscAddressPattern, const char* oscTypeTagString);
+int OscMessageTemplateSetInt32(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const int32_t int32);
+int OscMessageTemplateSetFloat32(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const float float32);
+int OscMessageTemplateSetInt64(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const uint64_t int64);
+int OscMessageTemplateSetTimeTag(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const OscTimeTag oscTimeTag);
+int OscMessageTemplateSetDouble(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const Double64 double64);
+int OscMessageTemplateSetCharacter(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const char asciiChar);
+int OscMessageTemplateSetRgbaColour(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const RgbaColour rgbaColour);
+int OscMessageTemplateSetMidiMessage(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const MidiMessage midiMessage);
+int OscMessageTemplateSetBool(OscMessageTemplate * const oscMessageTemplate, const int argumentNumber, const bool boolean);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
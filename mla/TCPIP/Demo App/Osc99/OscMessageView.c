@@ -0,0 +1,515 @@
+/**
+ * @file OscMessageView.c
+ * @author Seb Madgwick
+ * @brief Functions and structures for deconstructing OSC messages in place.
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscMessageView.h"
+#include <string.h> // strlen
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static int GetOscStringSize(const char* const oscString, const size_t maxOscStringSize, size_t * const oscStringSize);
+static int GetArgumentSize(const OscTypeTag oscTypeTag, const char* const argument, const size_t maxArgumentSize, size_t * const argumentSize);
+static OscArgument32 ReadArgument32(const char* const source);
+static OscArgument64 ReadArgument64(const char* const source);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises an OSC message view from a char array contained within
+ * an OSC packet or OSC bundle.
+ *
+ * The OSC message is validated once by this function, including the size of
+ * every argument indicated by the OSC type tag string.  No bytes are copied.
+ * The OSC address pattern and OSC type tag string members point directly into
+ * the source and are null terminated.
+ *
+ * Example use:
+ * @code
+ * const char source[] = "/example\0\0\0\0,i\0\0\0\0\0\x7B";
+ * OscMessageView oscMessageView;
+ * if (OscMessageViewInitialise(&oscMessageView, source, sizeof(source) - 1) == 0) {
+ *     int32_t int32;
+ *     OscMessageViewGetInt32(&oscMessageView, &int32);
+ * }
+ * @endcode
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param source Address of the char array.
+ * @param sourceSize Number of bytes within the char array.
+ * @return 0 if successful.
+ */
+int OscMessageViewInitialise(OscMessageView * const oscMessageView, const char* const source, const size_t sourceSize) {
+    oscMessageView->oscTypeTagStringIndex = 1; // skip comma
+    oscMessageView->argumentsIndex = 0;
+
+    // Return error if not valid OSC message
+    if (sourceSize % 4 != 0) {
+        return 1; // error: size not multiple of 4
+    }
+    if (sourceSize < MIN_OSC_MESSAGE_SIZE) {
+        return 1; // error: too few bytes to contain an OSC message
+    }
+    if (source[0] != (char) OscContentsTypeMessage) {
+        return 1; // error: first byte is not '/'
+    }
+
+    // OSC address pattern
+    size_t sourceIndex = 0;
+    size_t oscStringSize;
+    if (GetOscStringSize(source, sourceSize, &oscStringSize) != 0) {
+        return 1; // error: unexpected end of source
+    }
+    oscMessageView->oscAddressPattern = source;
+    oscMessageView->oscAddressPatternLength = strlen(source);
+    sourceIndex += oscStringSize;
+
+    // OSC type tag string
+    if (sourceIndex >= sourceSize) {
+        return 1; // error: unexpected end of source
+    }
+    if (source[sourceIndex] != ',') {
+        return 1; // error: OSC type tag string does not start with ','
+    }
+    if (GetOscStringSize(&source[sourceIndex], sourceSize - sourceIndex, &oscStringSize) != 0) {
+        return 1; // error: unexpected end of source
+    }
+    oscMessageView->oscTypeTagString = &source[sourceIndex];
+    oscMessageView->oscTypeTagStringLength = strlen(&source[sourceIndex]);
+    sourceIndex += oscStringSize;
+
+    // Arguments
+    oscMessageView->arguments = &source[sourceIndex];
+    oscMessageView->argumentsSize = sourceSize - sourceIndex;
+
+    // Validate size of each argument
+    size_t argumentsIndex = 0;
+    const char* oscTypeTag = &oscMessageView->oscTypeTagString[1]; // skip comma
+    while (*oscTypeTag != '\0') {
+        size_t argumentSize;
+        if (GetArgumentSize((OscTypeTag) * oscTypeTag, &oscMessageView->arguments[argumentsIndex], oscMessageView->argumentsSize - argumentsIndex, &argumentSize) != 0) {
+            return 1; // error: invalid argument
+        }
+        argumentsIndex += argumentSize;
+        oscTypeTag++;
+    }
+    return 0;
+}
+
+/**
+ * @brief Returns true if an argument is available indicated by the current
+ * oscTypeTagStringIndex value.
+ * @param oscMessageView Address of the OSC message view structure.
+ * @return true if an argument is available.
+ */
+bool OscMessageViewIsArgumentAvailable(const OscMessageView * const oscMessageView) {
+    return oscMessageView->oscTypeTagStringIndex < oscMessageView->oscTypeTagStringLength;
+}
+
+/**
+ * @brief Returns OSC type tag of the next argument available within an OSC
+ * message view indicated by the current oscTypeTagStringIndex value.
+ *
+ * A null character (value zero) will be returned if no arguments are available.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @return Next type tag in type tag string.
+ */
+OscTypeTag OscMessageViewGetArgumentType(const OscMessageView * const oscMessageView) {
+    if (oscMessageView->oscTypeTagStringIndex >= oscMessageView->oscTypeTagStringLength) {
+        return '\0'; // error: end of type tag string
+    }
+    return (OscTypeTag) oscMessageView->oscTypeTagString[oscMessageView->oscTypeTagStringIndex];
+}
+
+/**
+ * @brief Skips the next argument available within an OSC message view
+ * indicated by the current oscTypeTagStringIndex value.
+ *
+ * Both the OSC type tag string index and the arguments index are advanced so
+ * that the following argument may be read directly.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @return 0 if successful.
+ */
+int OscMessageViewSkipArgument(OscMessageView * const oscMessageView) {
+    if (oscMessageView->oscTypeTagStringIndex >= oscMessageView->oscTypeTagStringLength) {
+        return 1; // error: end of type tag string
+    }
+    size_t argumentSize;
+    if (GetArgumentSize(OscMessageViewGetArgumentType(oscMessageView), &oscMessageView->arguments[oscMessageView->argumentsIndex], oscMessageView->argumentsSize - oscMessageView->argumentsIndex, &argumentSize) != 0) {
+        return 1; // error: invalid argument
+    }
+    oscMessageView->argumentsIndex += argumentSize;
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a 32-bit integer argument from an OSC message view.
+ *
+ * The next argument available must be a 32-bit integer else this function will
+ * return an error.  The indexes will only be incremented to the next argument
+ * if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param int32 Address where the 32-bit integer value will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetInt32(OscMessageView * const oscMessageView, int32_t * const int32) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagInt32) {
+        return 1; // error: unexpected argument type
+    }
+    *int32 = ReadArgument32(&oscMessageView->arguments[oscMessageView->argumentsIndex]).int32;
+    oscMessageView->argumentsIndex += sizeof (OscArgument32);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a 32-bit float argument from an OSC message view.
+ *
+ * The next argument available must be a 32-bit float else this function will
+ * return an error.  The indexes will only be incremented to the next argument
+ * if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param float32 Address where the 32-bit float value will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetFloat32(OscMessageView * const oscMessageView, float * const float32) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagFloat32) {
+        return 1; // error: unexpected argument type
+    }
+    *float32 = ReadArgument32(&oscMessageView->arguments[oscMessageView->argumentsIndex]).float32;
+    oscMessageView->argumentsIndex += sizeof (OscArgument32);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a string or alternate string argument from an OSC message view.
+ *
+ * The next argument available must be a string else this function will return
+ * an error.  The address written is that of the null terminated string within
+ * the source.  The indexes will only be incremented to the next argument if
+ * this function is successful.
+ *
+ * Example use:
+ * @code
+ * const char* string;
+ * size_t stringLength;
+ * if (OscMessageViewGetString(&oscMessageView, &string, &stringLength) == 0) {
+ *     printf("Value = %s", string);
+ * }
+ * @endcode
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param string Address where the string address will be written.
+ * @param stringLength Address where the string length (excluding the
+ * terminating null character) will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetString(OscMessageView * const oscMessageView, const char* * const string, size_t * const stringLength) {
+    const OscTypeTag oscTypeTag = OscMessageViewGetArgumentType(oscMessageView);
+    if (oscTypeTag != OscTypeTagString && oscTypeTag != OscTypeTagAlternateString) {
+        return 1; // error: unexpected argument type
+    }
+    size_t argumentSize;
+    GetArgumentSize(oscTypeTag, &oscMessageView->arguments[oscMessageView->argumentsIndex], oscMessageView->argumentsSize - oscMessageView->argumentsIndex, &argumentSize); // validated by OscMessageViewInitialise
+    *string = &oscMessageView->arguments[oscMessageView->argumentsIndex];
+    *stringLength = strlen(*string);
+    oscMessageView->argumentsIndex += argumentSize;
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a blob (byte array) argument from an OSC message view.
+ *
+ * The next argument available must be a blob else this function will return an
+ * error.  The address written is that of the first byte of the blob within the
+ * source.  The indexes will only be incremented to the next argument if this
+ * function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param blob Address where the blob address will be written.
+ * @param blobSize Address where the blob size (number of bytes) will be
+ * written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetBlob(OscMessageView * const oscMessageView, const char* * const blob, size_t * const blobSize) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagBlob) {
+        return 1; // error: unexpected argument type
+    }
+    size_t argumentSize;
+    GetArgumentSize(OscTypeTagBlob, &oscMessageView->arguments[oscMessageView->argumentsIndex], oscMessageView->argumentsSize - oscMessageView->argumentsIndex, &argumentSize); // validated by OscMessageViewInitialise
+    *blobSize = (size_t) ReadArgument32(&oscMessageView->arguments[oscMessageView->argumentsIndex]).int32;
+    *blob = &oscMessageView->arguments[oscMessageView->argumentsIndex + sizeof (OscArgument32)];
+    oscMessageView->argumentsIndex += argumentSize;
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a 64-bit integer argument from an OSC message view.
+ *
+ * The next argument available must be a 64-bit integer else this function will
+ * return an error.  The indexes will only be incremented to the next argument
+ * if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param int64 Address where the 64-bit integer value will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetInt64(OscMessageView * const oscMessageView, int64_t * const int64) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagInt64) {
+        return 1; // error: unexpected argument type
+    }
+    *int64 = (int64_t) ReadArgument64(&oscMessageView->arguments[oscMessageView->argumentsIndex]).int64;
+    oscMessageView->argumentsIndex += sizeof (OscArgument64);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets an OSC time tag argument from an OSC message view.
+ *
+ * The next argument available must be an OSC time tag else this function will
+ * return an error.  The indexes will only be incremented to the next argument
+ * if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param oscTimeTag Address where the OSC time tag value will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetTimeTag(OscMessageView * const oscMessageView, OscTimeTag * const oscTimeTag) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagTimeTag) {
+        return 1; // error: unexpected argument type
+    }
+    *oscTimeTag = ReadArgument64(&oscMessageView->arguments[oscMessageView->argumentsIndex]).oscTimeTag;
+    oscMessageView->argumentsIndex += sizeof (OscTimeTag);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a 64-bit double argument from an OSC message view.
+ *
+ * The next argument available must be a 64-bit double else this function will
+ * return an error.  The indexes will only be incremented to the next argument
+ * if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param double64 Address where the 64-bit double value will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetDouble(OscMessageView * const oscMessageView, Double64 * const double64) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagDouble) {
+        return 1; // error: unexpected argument type
+    }
+    *double64 = ReadArgument64(&oscMessageView->arguments[oscMessageView->argumentsIndex]).double64;
+    oscMessageView->argumentsIndex += sizeof (OscArgument64);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a character argument from an OSC message view.
+ *
+ * The next argument available must be a character else this function will
+ * return an error.  The indexes will only be incremented to the next argument
+ * if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param character Address where the character value will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetCharacter(OscMessageView * const oscMessageView, char* const character) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagCharacter) {
+        return 1; // error: unexpected argument type
+    }
+    *character = oscMessageView->arguments[oscMessageView->argumentsIndex + 3];
+    oscMessageView->argumentsIndex += sizeof (OscArgument32);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a 32 bit RGBA colour argument from an OSC message view.
+ *
+ * The next argument available must be a 32 bit RGBA colour else this function
+ * will return an error.  The indexes will only be incremented to the next
+ * argument if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param rgbaColour Address where the 32 bit RGBA colour will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetRgbaColour(OscMessageView * const oscMessageView, RgbaColour * const rgbaColour) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagRgbaColour) {
+        return 1; // error: unexpected argument type
+    }
+    *rgbaColour = ReadArgument32(&oscMessageView->arguments[oscMessageView->argumentsIndex]).rgbaColour;
+    oscMessageView->argumentsIndex += sizeof (OscArgument32);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets a 4 byte MIDI message argument from an OSC message view.
+ *
+ * The next argument available must be a 4 byte MIDI message else this function
+ * will return an error.  The indexes will only be incremented to the next
+ * argument if this function is successful.
+ *
+ * @param oscMessageView Address of the OSC message view structure.
+ * @param midiMessage Address where the 4 byte MIDI message will be written.
+ * @return 0 if successful.
+ */
+int OscMessageViewGetMidiMessage(OscMessageView * const oscMessageView, MidiMessage * const midiMessage) {
+    if (OscMessageViewGetArgumentType(oscMessageView) != OscTypeTagMidiMessage) {
+        return 1; // error: unexpected argument type
+    }
+    *midiMessage = ReadArgument32(&oscMessageView->arguments[oscMessageView->argumentsIndex]).midiMessage;
+    oscMessageView->argumentsIndex += sizeof (OscArgument32);
+    oscMessageView->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Gets the size (number of bytes) of an OSC string including the
+ * terminating null characters.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscString Address of the OSC string.
+ * @param maxOscStringSize Maximum size of the OSC string that cannot be
+ * exceeded.
+ * @param oscStringSize Address where the OSC string size will be written.
+ * @return 0 if successful.
+ */
+static int GetOscStringSize(const char* const oscString, const size_t maxOscStringSize, size_t * const oscStringSize) {
+    size_t size = 0;
+    while (size < maxOscStringSize) {
+        if (oscString[size++] == '\0') {
+            if (size % 4 != 0) {
+                size += 4 - size % 4; // increase to multiple of 4
+            }
+            if (size > maxOscStringSize) {
+                return 1; // error: padding exceeds maximum size
+            }
+            *oscStringSize = size;
+            return 0;
+        }
+    }
+    return 1; // error: string not terminated
+}
+
+/**
+ * @brief Gets the size (number of bytes) of an argument.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscTypeTag OSC type tag of the argument.
+ * @param argument Address of the first byte of the argument.
+ * @param maxArgumentSize Maximum size of the argument that cannot be exceeded.
+ * @param argumentSize Address where the argument size will be written.
+ * @return 0 if successful.
+ */
+static int GetArgumentSize(const OscTypeTag oscTypeTag, const char* const argument, const size_t maxArgumentSize, size_t * const argumentSize) {
+    switch (oscTypeTag) {
+        case OscTypeTagInt32:
+        case OscTypeTagFloat32:
+        case OscTypeTagCharacter:
+        case OscTypeTagRgbaColour:
+        case OscTypeTagMidiMessage:
+            *argumentSize = sizeof (OscArgument32);
+            break;
+        case OscTypeTagInt64:
+        case OscTypeTagTimeTag:
+        case OscTypeTagDouble:
+            *argumentSize = sizeof (OscArgument64);
+            break;
+        case OscTypeTagString:
+        case OscTypeTagAlternateString:
+            return GetOscStringSize(argument, maxArgumentSize, argumentSize);
+        case OscTypeTagBlob:
+        {
+            if (sizeof (OscArgument32) > maxArgumentSize) {
+                return 1; // error: message too short to contain argument
+            }
+            const int32_t blobSize = ReadArgument32(argument).int32;
+            if (blobSize < 0) {
+                return 1; // error: size cannot be negative
+            }
+            *argumentSize = sizeof (OscArgument32) + (size_t) blobSize;
+            if (*argumentSize % 4 != 0) {
+                *argumentSize += 4 - *argumentSize % 4; // increase to multiple of 4
+            }
+            break;
+        }
+        case OscTypeTagTrue:
+        case OscTypeTagFalse:
+        case OscTypeTagNil:
+        case OscTypeTagInfinitum:
+        case OscTypeTagBeginArray:
+        case OscTypeTagEndArray:
+            *argumentSize = 0;
+            break;
+        default:
+            return 1; // error: unknown argument type
+    }
+    if (*argumentSize > maxArgumentSize) {
+        return 1; // error: message too short to contain argument
+    }
+    return 0;
+}
+
+/**
+ * @brief Reads a big-endian 32-bit argument.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param source Address of the first byte of the argument.
+ * @return 32-bit argument.
+ */
+static OscArgument32 ReadArgument32(const char* const source) {
+    OscArgument32 oscArgument32;
+    oscArgument32.byteStruct.byte3 = source[0];
+    oscArgument32.byteStruct.byte2 = source[1];
+    oscArgument32.byteStruct.byte1 = source[2];
+    oscArgument32.byteStruct.byte0 = source[3];
+    return oscArgument32;
+}
+
+/**
+ * @brief Reads a big-endian 64-bit argument.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param source Address of the first byte of the argument.
+ * @return 64-bit argument.
+ */
+static OscArgument64 ReadArgument64(const char* const source) {
+    OscArgument64 oscArgument64;
+    oscArgument64.byteStruct.byte7 = source[0];
+    oscArgument64.byteStruct.byte6 = source[1];
+    oscArgument64.byteStruct.byte5 = source[2];
+    oscArgument64.byteStruct.byte4 = source[3];
+    oscArgument64.byteStruct.byte3 = source[4];
+    oscArgument64.byteStruct.byte2 = source[5];
+    oscArgument64.byteStruct.byte1 = source[6];
+    oscArgument64.byteStruct.byte0 = source[7];
+    return oscArgument64;
+}
+
+//------------------------------------------------------------------------------
+// End of file
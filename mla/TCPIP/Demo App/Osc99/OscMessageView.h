@@ -0,0 +1,64 @@
+/**
+ * @file OscMessageView.h
+ * @author Seb Madgwick
+ * @brief Functions and structures for deconstructing OSC messages in place.
+ *
+ * An OSC message view references the bytes of a received OSC message rather
+ * than copying them into an OscMessage structure.  The source bytes must
+ * remain valid and unmodified for as long as the view is used.
+ *
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+#ifndef OSC_MESSAGE_VIEW_H
+#define OSC_MESSAGE_VIEW_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscCommon.h"
+#include "OscMessage.h"
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t, NULL
+#include <stdint.h> // int32_t, int64_t
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief OSC message view structure.  Must be initialised using
+ * OscMessageViewInitialise.
+ */
+typedef struct {
+    const char* oscAddressPattern; // null terminated, points into source
+    const char* oscTypeTagString; // includes comma, null terminated, points into source
+    const char* arguments; // points into source
+    size_t oscAddressPatternLength; // does not include null characters
+    size_t oscTypeTagStringLength; // includes comma but not null characters
+    size_t argumentsSize;
+    int oscTypeTagStringIndex;
+    int argumentsIndex;
+} OscMessageView;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+int OscMessageViewInitialise(OscMessageView * const oscMessageView, const char* const source, const size_t sourceSize);
+bool OscMessageViewIsArgumentAvailable(const OscMessageView * const oscMessageView);
+OscTypeTag OscMessageViewGetArgumentType(const OscMessageView * const oscMessageView);
+int OscMessageViewSkipArgument(OscMessageView * const oscMessageView);
+int OscMessageViewGetInt32(OscMessageView * const oscMessageView, int32_t * const int32);
+int OscMessageViewGetFloat32(OscMessageView * const oscMessageView, float * const float32);
+int OscMessageViewGetString(OscMessageView * const oscMessageView, const char* * const string, size_t * const stringLength);
+int OscMessageViewGetBlob(OscMessageView * const oscMessageView, const char* * const blob, size_t * const blobSize);
+int OscMessageViewGetInt64(OscMessageView * const oscMessageView, int64_t * const int64);
+int OscMessageViewGetTimeTag(OscMessageView * const oscMessageView, OscTimeTag * const oscTimeTag);
+int OscMessageViewGetDouble(OscMessageView * const oscMessageView, Double64 * const double64);
+int OscMessageViewGetCharacter(OscMessageView * const oscMessageView, char* const character);
+int OscMessageViewGetRgbaColour(OscMessageView * const oscMessageView, RgbaColour * const rgbaColour);
+int OscMessageViewGetMidiMessage(OscMessageView * const oscMessageView, MidiMessage * const midiMessage);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
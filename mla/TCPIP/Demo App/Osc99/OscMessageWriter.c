@@ -0,0 +1,404 @@
+/**
+ * @file OscMessageWriter.c
+ * @author Seb Madgwick
+ * @brief Functions and structures for constructing OSC messages in place.
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscMessageWriter.h"
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static int WriteOscString(OscMessageWriter * const oscMessageWriter, const char* oscString);
+static int BeginArgument(OscMessageWriter * const oscMessageWriter, const OscTypeTag oscTypeTag, const size_t argumentSize);
+static void SkipArgumentsWithoutData(OscMessageWriter * const oscMessageWriter);
+static void WriteArgument32(char* const destination, const OscArgument32 oscArgument32);
+static void WriteArgument64(char* const destination, const OscArgument64 oscArgument64);
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises an OSC message writer and writes the OSC address pattern
+ * and OSC type tag string to the destination.
+ *
+ * The OSC type tag string must start with a comma and describe every argument
+ * that will be added.  Arguments must then be added in the order declared.
+ * Arguments that have no data (true, false, nil, infinitum, begin array and
+ * end array) are completely described by the OSC type tag string and so are
+ * skipped automatically.
+ *
+ * If this function is unsuccessful then the OSC message writer is invalid and
+ * OscMessageWriterFinalise will return an error.
+ *
+ * Example use:
+ * @code
+ * char destination[32];
+ * OscMessageWriter oscMessageWriter;
+ * OscMessageWriterInitialise(&oscMessageWriter, destination, sizeof(destination), "/example", ",if");
+ * OscMessageWriterAddInt32(&oscMessageWriter, 123);
+ * OscMessageWriterAddFloat32(&oscMessageWriter, 1.0f);
+ * size_t oscMessageSize;
+ * OscMessageWriterFinalise(&oscMessageWriter, &oscMessageSize);
+ * @endcode
+ *
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param destination Address of the destination char array.
+ * @param destinationSize Size of the destination that cannot be exceeded.
+ * @param oscAddressPattern OSC address pattern as null terminated string.
+ * @param oscTypeTagString OSC type tag string (including comma) as null
+ * terminated string.
+ * @return 0 if successful.
+ */
+int OscMessageWriterInitialise(OscMessageWriter * const oscMessageWriter, char* const destination, const size_t destinationSize, const char* oscAddressPattern, const char* oscTypeTagString) {
+    oscMessageWriter->destination = destination;
+    oscMessageWriter->destinationSize = destinationSize;
+    oscMessageWriter->size = 0;
+    oscMessageWriter->oscTypeTagString = ",";
+    oscMessageWriter->oscTypeTagStringIndex = 1; // skip comma
+    if (*oscAddressPattern != (char) OscContentsTypeMessage) {
+        return 1; // error: address pattern does not start with '/'
+    }
+    if (*oscTypeTagString != ',') {
+        return 1; // error: OSC type tag string does not start with ','
+    }
+    if (WriteOscString(oscMessageWriter, oscAddressPattern) != 0) {
+        return 1; // error: destination too small
+    }
+    const size_t oscTypeTagStringIndex = oscMessageWriter->size;
+    if (WriteOscString(oscMessageWriter, oscTypeTagString) != 0) {
+        oscMessageWriter->size = 0; // invalid until initialised successfully
+        return 1; // error: destination too small
+    }
+    oscMessageWriter->oscTypeTagString = &destination[oscTypeTagStringIndex];
+    return 0;
+}
+
+/**
+ * @brief Writes a 32-bit integer argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param int32 32-bit integer to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddInt32(OscMessageWriter * const oscMessageWriter, const int32_t int32) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagInt32, sizeof (OscArgument32)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.int32 = int32;
+    WriteArgument32(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument32);
+    oscMessageWriter->size += sizeof (OscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Writes a 32-bit float argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param float32 32-bit float to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddFloat32(OscMessageWriter * const oscMessageWriter, const float float32) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagFloat32, sizeof (OscArgument32)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.float32 = float32;
+    WriteArgument32(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument32);
+    oscMessageWriter->size += sizeof (OscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Writes a string or alternate string argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param string String to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddString(OscMessageWriter * const oscMessageWriter, const char* string) {
+    SkipArgumentsWithoutData(oscMessageWriter);
+    const OscTypeTag oscTypeTag = (OscTypeTag) oscMessageWriter->oscTypeTagString[oscMessageWriter->oscTypeTagStringIndex];
+    if (oscTypeTag != OscTypeTagString && oscTypeTag != OscTypeTagAlternateString) {
+        return 1; // error: unexpected argument type
+    }
+    if (WriteOscString(oscMessageWriter, string) != 0) {
+        return 1; // error: destination full
+    }
+    oscMessageWriter->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Writes a blob (byte array) argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param source Address of the byte array to be written.
+ * @param sourceSize Size (number of bytes) of the byte array.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddBlob(OscMessageWriter * const oscMessageWriter, const char* const source, const size_t sourceSize) {
+    size_t argumentSize = sizeof (OscArgument32) + sourceSize;
+    if (argumentSize % 4 != 0) {
+        argumentSize += 4 - argumentSize % 4; // increase to multiple of 4
+    }
+    if (BeginArgument(oscMessageWriter, OscTypeTagBlob, argumentSize) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument32 blobSize;
+    blobSize.int32 = (int32_t) sourceSize;
+    WriteArgument32(&oscMessageWriter->destination[oscMessageWriter->size], blobSize);
+    size_t destinationIndex = oscMessageWriter->size + sizeof (OscArgument32);
+    size_t sourceIndex;
+    for (sourceIndex = 0; sourceIndex < sourceSize; sourceIndex++) {
+        oscMessageWriter->destination[destinationIndex++] = source[sourceIndex];
+    }
+    oscMessageWriter->size += argumentSize;
+    while (destinationIndex < oscMessageWriter->size) {
+        oscMessageWriter->destination[destinationIndex++] = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Writes a 64-bit integer argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param int64 64-bit integer to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddInt64(OscMessageWriter * const oscMessageWriter, const uint64_t int64) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagInt64, sizeof (OscArgument64)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument64 oscArgument64;
+    oscArgument64.int64 = int64;
+    WriteArgument64(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument64);
+    oscMessageWriter->size += sizeof (OscArgument64);
+    return 0;
+}
+
+/**
+ * @brief Writes an OSC time tag argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param oscTimeTag OSC time tag to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddTimeTag(OscMessageWriter * const oscMessageWriter, const OscTimeTag oscTimeTag) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagTimeTag, sizeof (OscArgument64)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument64 oscArgument64;
+    oscArgument64.oscTimeTag = oscTimeTag;
+    WriteArgument64(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument64);
+    oscMessageWriter->size += sizeof (OscArgument64);
+    return 0;
+}
+
+/**
+ * @brief Writes a 64-bit double argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param double64 64-bit double to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddDouble(OscMessageWriter * const oscMessageWriter, const Double64 double64) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagDouble, sizeof (OscArgument64)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument64 oscArgument64;
+    oscArgument64.double64 = double64;
+    WriteArgument64(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument64);
+    oscMessageWriter->size += sizeof (OscArgument64);
+    return 0;
+}
+
+/**
+ * @brief Writes a character argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param asciiChar Character to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddCharacter(OscMessageWriter * const oscMessageWriter, const char asciiChar) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagCharacter, sizeof (OscArgument32)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    oscMessageWriter->destination[oscMessageWriter->size++] = 0;
+    oscMessageWriter->destination[oscMessageWriter->size++] = 0;
+    oscMessageWriter->destination[oscMessageWriter->size++] = 0;
+    oscMessageWriter->destination[oscMessageWriter->size++] = asciiChar;
+    return 0;
+}
+
+/**
+ * @brief Writes a 32-bit RGBA colour argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param rgbaColour 32-bit RGBA colour to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddRgbaColour(OscMessageWriter * const oscMessageWriter, const RgbaColour rgbaColour) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagRgbaColour, sizeof (OscArgument32)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.rgbaColour = rgbaColour;
+    WriteArgument32(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument32);
+    oscMessageWriter->size += sizeof (OscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Writes a 4 byte MIDI message argument to the destination.
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param midiMessage 4 byte MIDI message to be written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterAddMidiMessage(OscMessageWriter * const oscMessageWriter, const MidiMessage midiMessage) {
+    if (BeginArgument(oscMessageWriter, OscTypeTagMidiMessage, sizeof (OscArgument32)) != 0) {
+        return 1; // error: unexpected argument type or destination full
+    }
+    OscArgument32 oscArgument32;
+    oscArgument32.midiMessage = midiMessage;
+    WriteArgument32(&oscMessageWriter->destination[oscMessageWriter->size], oscArgument32);
+    oscMessageWriter->size += sizeof (OscArgument32);
+    return 0;
+}
+
+/**
+ * @brief Completes the OSC message and provides its size.
+ *
+ * This function will return an error if the OSC message writer was not
+ * initialised successfully or if any argument declared by the OSC type tag
+ * string has not been added.  The destination then contains a complete OSC
+ * message of the size provided.
+ *
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param oscMessageSize Address where the size of the OSC message will be
+ * written.
+ * @return 0 if successful.
+ */
+int OscMessageWriterFinalise(OscMessageWriter * const oscMessageWriter, size_t * const oscMessageSize) {
+    *oscMessageSize = 0; // size will be 0 if function unsuccessful
+    if (oscMessageWriter->size == 0) {
+        return 1; // error: OSC message writer not initialised
+    }
+    SkipArgumentsWithoutData(oscMessageWriter);
+    if (oscMessageWriter->oscTypeTagString[oscMessageWriter->oscTypeTagStringIndex] != '\0') {
+        return 1; // error: arguments remaining
+    }
+    *oscMessageSize = oscMessageWriter->size;
+    return 0;
+}
+
+/**
+ * @brief Writes an OSC string to the destination including the terminating
+ * null characters.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param oscString String to be written.
+ * @return 0 if successful.
+ */
+static int WriteOscString(OscMessageWriter * const oscMessageWriter, const char* oscString) {
+    size_t size = oscMessageWriter->size; // local copy in case function returns error
+    while (*oscString != '\0') {
+        if (size >= oscMessageWriter->destinationSize) {
+            return 1; // error: destination full
+        }
+        oscMessageWriter->destination[size++] = *oscString++;
+    }
+    do {
+        if (size >= oscMessageWriter->destinationSize) {
+            return 1; // error: destination full
+        }
+        oscMessageWriter->destination[size++] = '\0';
+    } while (size % 4 != 0);
+    oscMessageWriter->size = size;
+    return 0;
+}
+
+/**
+ * @brief Confirms that the next argument declared by the OSC type tag string
+ * is of the expected type and that the destination has space for it.  The OSC
+ * type tag string index is advanced if successful.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ * @param oscTypeTag Expected OSC type tag.
+ * @param argumentSize Size (number of bytes) of the argument.
+ * @return 0 if successful.
+ */
+static int BeginArgument(OscMessageWriter * const oscMessageWriter, const OscTypeTag oscTypeTag, const size_t argumentSize) {
+    SkipArgumentsWithoutData(oscMessageWriter);
+    if (oscMessageWriter->oscTypeTagString[oscMessageWriter->oscTypeTagStringIndex] != (char) oscTypeTag) {
+        return 1; // error: unexpected argument type
+    }
+    if (oscMessageWriter->size + argumentSize > oscMessageWriter->destinationSize) {
+        return 1; // error: destination full
+    }
+    oscMessageWriter->oscTypeTagStringIndex++;
+    return 0;
+}
+
+/**
+ * @brief Advances the OSC type tag string index past any arguments that have
+ * no data.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param oscMessageWriter Address of the OSC message writer structure.
+ */
+static void SkipArgumentsWithoutData(OscMessageWriter * const oscMessageWriter) {
+    while (1) {
+        switch ((OscTypeTag) oscMessageWriter->oscTypeTagString[oscMessageWriter->oscTypeTagStringIndex]) {
+            case OscTypeTagTrue:
+            case OscTypeTagFalse:
+            case OscTypeTagNil:
+            case OscTypeTagInfinitum:
+            case OscTypeTagBeginArray:
+            case OscTypeTagEndArray:
+                oscMessageWriter->oscTypeTagStringIndex++;
+                break;
+            default:
+                return;
+        }
+    }
+}
+
+/**
+ * @brief Writes a 32-bit argument as big-endian.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param destination Address of the first byte of the argument.
+ * @param oscArgument32 32-bit argument.
+ */
+static void WriteArgument32(char* const destination, const OscArgument32 oscArgument32) {
+    destination[0] = oscArgument32.byteStruct.byte3;
+    destination[1] = oscArgument32.byteStruct.byte2;
+    destination[2] = oscArgument32.byteStruct.byte1;
+    destination[3] = oscArgument32.byteStruct.byte0;
+}
+
+/**
+ * @brief Writes a 64-bit argument as big-endian.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param destination Address of the first byte of the argument.
+ * @param oscArgument64 64-bit argument.
+ */
+static void WriteArgument64(char* const destination, const OscArgument64 oscArgument64) {
+    destination[0] = oscArgument64.byteStruct.byte7;
+    destination[1] = oscArgument64.byteStruct.byte6;
+    destination[2] = oscArgument64.byteStruct.byte5;
+    destination[3] = oscArgument64.byteStruct.byte4;
+    destination[4] = oscArgument64.byteStruct.byte3;
+    destination[5] = oscArgument64.byteStruct.byte2;
+    destination[6] = oscArgument64.byteStruct.byte1;
+    destination[7] = oscArgument64.byteStruct.byte0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
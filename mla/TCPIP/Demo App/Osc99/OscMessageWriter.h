@@ -0,0 +1,60 @@
+/**
+ * @file OscMessageWriter.h
+ * @author Seb Madgwick
+ * @brief Functions and structures for constructing OSC messages in place.
+ *
+ * An OSC message writer serialises an OSC message directly into a destination
+ * char array, such as a transport transmit buffer, in a single pass.  Unlike
+ * an OscMessage structure, no intermediate copy of the message is held.  The
+ * OSC type tag string must be declared up front so that the OSC address
+ * pattern and OSC type tag string may be written before the arguments.
+ *
+ * @see http://opensoundcontrol.org/spec-1_0
+ */
+
+#ifndef OSC_MESSAGE_WRITER_H
+#define OSC_MESSAGE_WRITER_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "OscCommon.h"
+#include "OscMessage.h"
+#include <stddef.h> // size_t, NULL
+#include <stdint.h> // int32_t, uint64_t
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief OSC message writer structure.  Must be initialised using
+ * OscMessageWriterInitialise.
+ */
+typedef struct {
+    char* destination;
+    size_t destinationSize;
+    size_t size; // number of bytes written to destination
+    const char* oscTypeTagString; // includes comma, null terminated, points into destination
+    int oscTypeTagStringIndex;
+} OscMessageWriter;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+int OscMessageWriterInitialise(OscMessageWriter * const oscMessageWriter, char* const destination, const size_t destinationSize, const char* oscAddressPattern, const char* oscTypeTagString);
+int OscMessageWriterAddInt32(OscMessageWriter * const oscMessageWriter, const int32_t int32);
+int OscMessageWriterAddFloat32(OscMessageWriter * const oscMessageWriter, const float float32);
+int OscMessageWriterAddString(OscMessageWriter * const oscMessageWriter, const char* string);
+int OscMessageWriterAddBlob(OscMessageWriter * const oscMessageWriter, const char* const source, const size_t sourceSize);
+int OscMessageWriterAddInt64(OscMessageWriter * const oscMessageWriter, const uint64_t int64);
+int OscMessageWriterAddTimeTag(OscMessageWriter * const oscMessageWriter, const OscTimeTag oscTimeTag);
+int OscMessageWriterAddDouble(OscMessageWriter * const oscMessageWriter, const Double64 double64);
+int OscMessageWriterAddCharacter(OscMessageWriter * const oscMessageWriter, const char asciiChar);
+int OscMessageWriterAddRgbaColour(OscMessageWriter * const oscMessageWriter, const RgbaColour rgbaColour);
+int OscMessageWriterAddMidiMessage(OscMessageWriter * const oscMessageWriter, const MidiMessage midiMessage);
+int OscMessageWriterFinalise(OscMessageWriter * const oscMessageWriter, size_t * const oscMessageSize);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
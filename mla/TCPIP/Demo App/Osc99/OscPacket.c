@@ -10,12 +10,12 @@
 // Includes
 
 #include "OscPacket.h"
-#include <stdbool.h> // bool, true, false
 
 //------------------------------------------------------------------------------
 // Function prototypes
 
-static int DeconstructContents(OscPacket * const oscPacket, const OscTimeTag * const oscTimeTag, const OscContents * const oscContents, const size_t contentsSize);
+static int GetNextContents(OscPacketIterator * const oscPacketIterator, const OscTimeTag * * const oscTimeTag, const char* * const contents, size_t * const contentsSize);
+static OscArgument32 ReadArgument32(const char* const source);
 
 //------------------------------------------------------------------------------
 // Functions
@@ -43,6 +43,22 @@ static int DeconstructContents(OscPacket * const oscPacket, const OscTimeTag * c
  * @param oscPacket Address of the OSC packet to be initialised.
  */
 void OscPacketInitialise(OscPacket * const oscPacket) {
+    OSC_PACKET_INITIALISE(oscPacket);
+}
+
+/**
+ * @brief Initialises an OSC packet structure with the specified storage.
+ *
+ * This function is used by OSC_PACKET_INITIALISE and should not be called
+ * directly by the user application.
+ *
+ * @param oscPacket Address of the OSC packet to be initialised.
+ * @param contents Storage for the contents.
+ * @param maxSize Size of the contents storage.
+ */
+void OscPacketInitialiseWithStorage(OscPacket * const oscPacket, char* const contents, const size_t maxSize) {
+    oscPacket->contents = contents;
+    oscPacket->maxSize = maxSize;
     oscPacket->size = 0;
     oscPacket->processMessage = NULL;
 }
@@ -54,13 +70,16 @@ void OscPacketInitialise(OscPacket * const oscPacket) {
  * An OSC packet structure must be initialised before use.  This function is
  * used to initialise an OSC packet structure from either OSC message or OSC
  * bundle and is typically of use when constructing an OSC packet for
- * transmission.
+ * transmission.  The OSC packet must first have been initialised using either
+ * OscPacketInitialise or OSC_PACKET_INITIALISE so that the storage and capacity
+ * of the OSC packet type are retained.
  *
  * Example use:
  * @code
  * OscMessage oscMessage;
  * OscMessageInitialise(&oscMessage, "/example");
  * OscPacket oscPacket;
+ * OscPacketInitialise(&oscPacket);
  * OscPacketInitialiseFromContents(&oscPacket, &oscMessage);
  * @endcode
  *
@@ -69,18 +88,15 @@ void OscPacketInitialise(OscPacket * const oscPacket) {
  * @return 0 if successful.
  */
 int OscPacketInitialiseFromContents(OscPacket * const oscPacket, const OscContents * const oscContents) {
-    oscPacket->processMessage = NULL;
+    OscPacketInitialiseWithStorage(oscPacket, oscPacket->contents, oscPacket->maxSize);
     int oscError = 1; // error: invalid or uninitialised OSC contents
     if (OSC_CONTENTS_IS_MESSAGE(oscContents)) {
-        oscError = OscMessageToCharArray((OscMessage*) oscContents, &oscPacket->size, oscPacket->contents, MAX_OSC_PACKET_SIZE);
+        oscError = OscMessageToCharArray((OscMessage*) oscContents, &oscPacket->size, oscPacket->contents, oscPacket->maxSize);
     }
     if (OSC_CONTENTS_IS_BUNDLE(oscContents)) {
-        oscError = OscBundleToCharArray((OscBundle*) oscContents, &oscPacket->size, oscPacket->contents, MAX_OSC_PACKET_SIZE);
+        oscError = OscBundleToCharArray((OscBundle*) oscContents, &oscPacket->size, oscPacket->contents, oscPacket->maxSize);
     }
-    if (oscError != 0) {
-        return oscError; // error: cascaded from above
-    }
-    return 1; // error: invalid or uninitialised contents
+    return oscError;
 }
 
 /**
@@ -88,11 +104,15 @@ int OscPacketInitialiseFromContents(OscPacket * const oscPacket, const OscConten
  *
  * An OSC packet structure must be initialised before use.  This function is
  * used to initialise an OSC packet structure from a char array and is typically
- * of use when constructing an OSC packet from received bytes.
+ * of use when constructing an OSC packet from received bytes.  The OSC packet
+ * must first have been initialised using either OscPacketInitialise or
+ * OSC_PACKET_INITIALISE so that the storage and capacity of the OSC packet type
+ * are retained.
  *
  * Example use:
  * @code
  * OscPacket oscPacket;
+ * OscPacketInitialise(&oscPacket);
  * const char source[] = "/example\0\0\0\0,\0\0"; // string terminating null character is part of OSC message
  * OscPacketInitialiseFromCharArray(&oscPacket, source, sizeof(source));
  * @endcode
@@ -103,15 +123,14 @@ int OscPacketInitialiseFromContents(OscPacket * const oscPacket, const OscConten
  * @return 0 if successful.
  */
 int OscPacketInitialiseFromCharArray(OscPacket * const oscPacket, const char* const source, const size_t sourceSize) {
-    oscPacket->size = 0;
-    if (sourceSize > MAX_OSC_PACKET_SIZE) {
+    OscPacketInitialiseWithStorage(oscPacket, oscPacket->contents, oscPacket->maxSize);
+    if (sourceSize > oscPacket->maxSize) {
         return 1; // error: size exceeds maximum packet size
     }
     while (oscPacket->size < sourceSize) {
         oscPacket->contents[oscPacket->size] = source[oscPacket->size];
         oscPacket->size++;
     }
-    oscPacket->processMessage = NULL;
     return 0;
 }
 
@@ -125,6 +144,9 @@ int OscPacketInitialiseFromCharArray(OscPacket * const oscPacket, const char* co
  * ProcessMessage function will be called for each OSC message found within the
  * OSC packet.
  *
+ * Nested OSC bundles are deconstructed using an OSC packet iterator so that
+ * only a single OSC message structure is required on the stack.
+ *
  * Example use:
  * @code
  * ProcessMessage(const OscTimeTag * const oscTimeTag, OscMessage * const oscMessage){
@@ -132,6 +154,7 @@ int OscPacketInitialiseFromCharArray(OscPacket * const oscPacket, const char* co
  *
  * void Main() {
  *     OscPacket oscPacket;
+ *     OscPacketInitialise(&oscPacket);
  *     const char source[] = "/example\0\0\0\0,\0\0\0";
  *     OscPacketInitialiseFromCharArray(&oscPacket, source, sizeof(source) - 1);
  *     oscPacket.processMessage = ProcessPacket;
@@ -146,60 +169,193 @@ int OscPacketProcessMessages(OscPacket * const oscPacket) {
     if (oscPacket->processMessage == NULL) {
         return 1; // error: user function undefined
     }
-    return (DeconstructContents(oscPacket, NULL, oscPacket->contents, oscPacket->size));
+    OscPacketIterator oscPacketIterator;
+    OscPacketIteratorInitialise(&oscPacketIterator, oscPacket->contents, oscPacket->size);
+    do {
+        const OscTimeTag* oscTimeTag;
+        const char* contents;
+        size_t contentsSize;
+        if (GetNextContents(&oscPacketIterator, &oscTimeTag, &contents, &contentsSize) != 0) {
+            return 1; // error: invalid contents
+        }
+        if (contents == NULL) {
+            return 0; // no more messages
+        }
+        OscMessage oscMessage;
+        OscMessageInitialise(&oscMessage, "");
+        OscMessageInitialiseFromCharArray(&oscMessage, contents, contentsSize);
+        oscPacket->processMessage(oscTimeTag, &oscMessage);
+    } while (true);
+}
+
+/**
+ * @brief Initialises an OSC packet iterator to step through each OSC message
+ * contained within an OSC packet.
+ *
+ * Nested OSC bundles are deconstructed iteratively using a fixed number of
+ * levels, MAX_OSC_BUNDLE_DEPTH, so that the stack usage is known at compile
+ * time.  No bytes are copied and so the source must remain valid and
+ * unmodified for as long as the iterator is used.
+ *
+ * Example use:
+ * @code
+ * OscPacketIterator oscPacketIterator;
+ * OscPacketIteratorInitialise(&oscPacketIterator, source, sourceSize);
+ * const OscTimeTag* oscTimeTag;
+ * OscMessageView oscMessageView;
+ * while (OscPacketNextMessage(&oscPacketIterator, &oscTimeTag, &oscMessageView) == 0) {
+ *     printf("%s", oscMessageView.oscAddressPattern);
+ * }
+ * @endcode
+ *
+ * @param oscPacketIterator Address of the OSC packet iterator structure.
+ * @param source Address of the OSC packet contents.
+ * @param sourceSize Size of the OSC packet contents.
+ */
+void OscPacketIteratorInitialise(OscPacketIterator * const oscPacketIterator, const char* const source, const size_t sourceSize) {
+    oscPacketIterator->source = source;
+    oscPacketIterator->sourceSize = sourceSize;
+    oscPacketIterator->isStarted = false;
+    oscPacketIterator->depth = 0;
 }
 
 /**
- * @brief Recursively deconstructs the OSC contents to provide each OSC message
- * to the user application with the associated OSC time tag (if the message is
- * contained within a bundle).
+ * @brief Gets the next OSC message contained within an OSC packet.
+ *
+ * The OSC time tag address provided is that of the OSC bundle directly
+ * containing the OSC message and is NULL if the OSC message is not contained
+ * within an OSC bundle.  The OSC time tag remains valid until this function is
+ * next called.
+ *
+ * @param oscPacketIterator Address of the OSC packet iterator structure.
+ * @param oscTimeTag Address where the OSC time tag address will be written.
+ * @param oscMessageView Address of the OSC message view structure that will be
+ * initialised with the OSC message.
+ * @return 0 if successful.  1 if no more OSC messages are available or the OSC
+ * packet is invalid.
+ */
+int OscPacketNextMessage(OscPacketIterator * const oscPacketIterator, const OscTimeTag * * const oscTimeTag, OscMessageView * const oscMessageView) {
+    const char* contents;
+    size_t contentsSize;
+    if (GetNextContents(oscPacketIterator, oscTimeTag, &contents, &contentsSize) != 0) {
+        return 1; // error: invalid contents
+    }
+    if (contents == NULL) {
+        return 1; // no more messages
+    }
+    return OscMessageViewInitialise(oscMessageView, contents, contentsSize);
+}
+
+/**
+ * @brief Gets the contents of the next OSC message within an OSC packet.
+ *
+ * Each OSC bundle found is pushed onto the fixed-size list of bundles within
+ * the iterator and is removed once all of its elements have been provided.
+ * The iterator will provide no further contents once an error has occurred.
  *
  * This is an internal function and cannot be called by the user application.
  *
- * @param oscPacket Address of the OSC packet containing a pointer to the
- * ProcessMessage user function.
- * @param oscTimeTag Address of the OSC time tag of the bundle containing the
- * OSC contents.  Should be NULL if the contents is not within an OSC bundle.
- * @param oscContents Address of the OSC contents to be deconstructed.
- * @param contentsSize Size of the OSC contents.
+ * @param oscPacketIterator Address of the OSC packet iterator structure.
+ * @param oscTimeTag Address where the OSC time tag address will be written.
+ * @param contents Address where the OSC message contents address will be
+ * written.  NULL if no more OSC messages are available.
+ * @param contentsSize Address where the OSC message contents size will be
+ * written.
  * @return 0 if successful.
  */
-static int DeconstructContents(OscPacket * const oscPacket, const OscTimeTag * const oscTimeTag, const OscContents * const oscContents, const size_t contentsSize) {
-    if (contentsSize == 0) {
-        return 1; // error: contents empty
-    }
+static int GetNextContents(OscPacketIterator * const oscPacketIterator, const OscTimeTag * * const oscTimeTag, const char* * const contents, size_t * const contentsSize) {
+    *contents = NULL;
+    do {
+        size_t index;
+        size_t size;
 
-    // Contents is message
-    if (OSC_CONTENTS_IS_MESSAGE(oscContents)) {
-        OscMessage oscMessage;
-        OscMessageInitialiseFromCharArray(&oscMessage, oscContents, contentsSize);
-        oscPacket->processMessage(oscTimeTag, &oscMessage);
-        return 0;
-    }
+        // Packet contents
+        if (oscPacketIterator->isStarted == false) {
+            oscPacketIterator->isStarted = true;
+            index = 0;
+            size = oscPacketIterator->sourceSize;
+            *oscTimeTag = NULL;
+        } else {
 
-    // Contents is bundle
-    if (OSC_CONTENTS_IS_BUNDLE(oscContents)) {
-        OscBundle oscBundle;
-        OscBundleInitialiseFromCharArray(&oscBundle, oscContents, contentsSize);
-        do {
-            OscBundleElement oscBundleElement;
-            if (!OscBundleIsBundleElementAvailable(&oscBundle)) {
-                break; // no more bundle elements
+            // Next bundle element
+            if (oscPacketIterator->depth == 0) {
+                return 0; // no more messages
             }
-            int oscError;
-            oscError = OscBundleGetBundleElement(&oscBundle, &oscBundleElement);
-            if (oscError != 0) {
-                return oscError; // error: get bundle element failed
+            const int bundleIndex = oscPacketIterator->depth - 1;
+            if (oscPacketIterator->bundles[bundleIndex].index + sizeof (OscArgument32) >= oscPacketIterator->bundles[bundleIndex].endIndex) {
+                oscPacketIterator->depth--;
+                continue; // no more bundle elements
             }
-            oscError = DeconstructContents(oscPacket, &oscBundle.oscTimeTag, oscBundleElement.contents, oscBundleElement.size.int32); // recursive deconstruction
-            if (oscError != 0) {
-                return oscError; // error: contents deconstruction failed
+            const int32_t elementSize = ReadArgument32(&oscPacketIterator->source[oscPacketIterator->bundles[bundleIndex].index]).int32;
+            oscPacketIterator->bundles[bundleIndex].index += sizeof (OscArgument32);
+            if (elementSize < 0) {
+                oscPacketIterator->depth = 0;
+                return 1; // error: size cannot be negative
             }
-        } while (true);
-        return 0;
-    }
+            if (elementSize % 4 != 0) {
+                oscPacketIterator->depth = 0;
+                return 1; // error: size not multiple of 4
+            }
+            if (oscPacketIterator->bundles[bundleIndex].index + elementSize > oscPacketIterator->bundles[bundleIndex].endIndex) {
+                oscPacketIterator->depth = 0;
+                return 1; // error: too few bytes for indicated size
+            }
+            index = oscPacketIterator->bundles[bundleIndex].index;
+            size = (size_t) elementSize;
+            oscPacketIterator->bundles[bundleIndex].index += size;
+            *oscTimeTag = &oscPacketIterator->bundles[bundleIndex].oscTimeTag;
+        }
+        if (size == 0) {
+            oscPacketIterator->depth = 0;
+            return 1; // error: contents empty
+        }
+
+        // Contents is message
+        if (oscPacketIterator->source[index] == (char) OscContentsTypeMessage) {
+            *contents = &oscPacketIterator->source[index];
+            *contentsSize = size;
+            return 0;
+        }
 
-    return 1; // error: invalid or uninitialised contents
+        // Contents is bundle
+        if ((oscPacketIterator->source[index] != (char) OscContentsTypeBundle) || (size % 4 != 0) || (size < MIN_OSC_BUNDLE_SIZE)) {
+            oscPacketIterator->depth = 0;
+            return 1; // error: invalid contents
+        }
+        if (oscPacketIterator->depth >= MAX_OSC_BUNDLE_DEPTH) {
+            oscPacketIterator->depth = 0;
+            return 1; // error: maximum bundle depth exceeded
+        }
+        const int bundleIndex = oscPacketIterator->depth++;
+        const char* const oscTimeTagSource = &oscPacketIterator->source[index + sizeof (OSC_BUNDLE_HEADER)];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte7 = oscTimeTagSource[0];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte6 = oscTimeTagSource[1];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte5 = oscTimeTagSource[2];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte4 = oscTimeTagSource[3];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte3 = oscTimeTagSource[4];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte2 = oscTimeTagSource[5];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte1 = oscTimeTagSource[6];
+        oscPacketIterator->bundles[bundleIndex].oscTimeTag.byteStruct.byte0 = oscTimeTagSource[7];
+        oscPacketIterator->bundles[bundleIndex].index = index + MIN_OSC_BUNDLE_SIZE;
+        oscPacketIterator->bundles[bundleIndex].endIndex = index + size;
+    } while (true);
+}
+
+/**
+ * @brief Reads a big-endian 32-bit argument.
+ *
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param source Address of the first byte of the argument.
+ * @return 32-bit argument.
+ */
+static OscArgument32 ReadArgument32(const char* const source) {
+    OscArgument32 oscArgument32;
+    oscArgument32.byteStruct.byte3 = source[0];
+    oscArgument32.byteStruct.byte2 = source[1];
+    oscArgument32.byteStruct.byte1 = source[2];
+    oscArgument32.byteStruct.byte0 = source[3];
+    return oscArgument32;
 }
 
 //------------------------------------------------------------------------------
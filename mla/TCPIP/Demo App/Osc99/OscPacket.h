@@ -3,6 +3,9 @@
  * @author Seb Madgwick
  * @brief Functions and structures for constructing and deconstructing OSC
  * packets.
+ *
+ * MAX_OSC_BUNDLE_DEPTH may be modified as required by the user application.
+ *
  * @see http://opensoundcontrol.org/spec-1_0
  */
 
@@ -15,6 +18,8 @@
 #include "OscBundle.h"
 #include "OscCommon.h"
 #include "OscMessage.h"
+#include "OscMessageView.h"
+#include <stdbool.h> // bool, true, false
 #include <stddef.h> // size_t, NULL
 
 //------------------------------------------------------------------------------
@@ -27,23 +32,91 @@
 #define MAX_OSC_PACKET_SIZE MAX_TRANSPORT_SIZE
 
 /**
- * @brief OSC packet structure.  Must be initialised using either
- * OscPacketInitialise,  OscPacketInitialiseFromContents, or
+ * @brief Members common to every OSC packet type.  The contents member points
+ * to the storage of the containing type and the capacity of that storage is
+ * held by the maxSize member.  An OSC packet must therefore not be copied by
+ * assignment.
+ */
+#define OSC_PACKET_HEADER \
+    char* contents; \
+    size_t maxSize; \
+    size_t size; \
+    void (*processMessage)(const OscTimeTag * const oscTimeTag, OscMessage * const oscMessage);
+
+/**
+ * @brief Macro that defines an OSC packet type of the specified capacity.  An
+ * OSC packet type must be initialised using OSC_PACKET_INITIALISE and passed to
+ * OSC packet functions using OSC_PACKET.
+ *
+ * Example use:
+ * @code
+ * OSC_PACKET_TYPE(SmallOscPacket, 64);
+ * SmallOscPacket smallOscPacket;
+ * OSC_PACKET_INITIALISE(&smallOscPacket);
+ * OscMessageToCharArray(&oscMessage, &smallOscPacket.size, smallOscPacket.contents, smallOscPacket.maxSize);
+ * @endcode
+ */
+#define OSC_PACKET_TYPE(name, maxSize_) \
+    typedef struct { \
+        OSC_PACKET_HEADER \
+        char contentsStorage[maxSize_]; \
+    } name
+
+/**
+ * @brief Macro that resolves as the address of an OSC packet type defined using
+ * OSC_PACKET_TYPE as an OscPacket pointer.
+ */
+#define OSC_PACKET(oscPacketType) ((OscPacket*) (oscPacketType))
+
+/**
+ * @brief Macro that initialises an OSC packet type defined using
+ * OSC_PACKET_TYPE.  Equivalent to OscPacketInitialise.
+ */
+#define OSC_PACKET_INITIALISE(oscPacketType) \
+    OscPacketInitialiseWithStorage(OSC_PACKET(oscPacketType), (oscPacketType)->contentsStorage, sizeof ((oscPacketType)->contentsStorage))
+
+/**
+ * @brief OSC packet structure of the default capacity.  Must be initialised
+ * using OscPacketInitialise before use with OscPacketInitialiseFromContents or
  * OscPacketInitialiseFromCharArray.
  */
+OSC_PACKET_TYPE(OscPacket, MAX_OSC_PACKET_SIZE);
+
+/**
+ * @brief Maximum depth of nested OSC bundles that may be deconstructed.  An
+ * OSC bundle within an OSC packet has a depth of 1.  This value may be modified
+ * as required by the user application.
+ */
+#define MAX_OSC_BUNDLE_DEPTH 4
+
+/**
+ * @brief OSC packet iterator structure.  Must be initialised using
+ * OscPacketIteratorInitialise.  This structure is used to step through each
+ * OSC message within an OSC packet without copying.
+ */
 typedef struct {
-    char contents[MAX_OSC_PACKET_SIZE];
-    size_t size;
-    void (*processMessage)(const OscTimeTag * const oscTimeTag, OscMessage * const oscMessage);
-} OscPacket;
+    const char* source;
+    size_t sourceSize;
+    bool isStarted;
+    int depth;
+
+    struct {
+        size_t index; // index of next bundle element within source
+        size_t endIndex; // index of end of bundle within source
+        OscTimeTag oscTimeTag;
+    } bundles[MAX_OSC_BUNDLE_DEPTH];
+} OscPacketIterator;
 
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void OscPacketInitialise(OscPacket * const oscPacket);
+void OscPacketInitialiseWithStorage(OscPacket * const oscPacket, char* const contents, const size_t maxSize);
 int OscPacketInitialiseFromContents(OscPacket * const oscPacket, const OscContents * const oscContents);
 int OscPacketInitialiseFromCharArray(OscPacket * const oscPacket, const char* const source, const size_t sourceSize);
 int OscPacketProcessMessages(OscPacket * const oscPacket);
+void OscPacketIteratorInitialise(OscPacketIterator * const oscPacketIterator, const char* const source, const size_t sourceSize);
+int OscPacketNextMessage(OscPacketIterator * const oscPacketIterator, const OscTimeTag * * const oscTimeTag, OscMessageView * const oscMessageView);
 
 #endif
 
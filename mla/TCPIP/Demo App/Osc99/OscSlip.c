@@ -11,6 +11,8 @@
 
 #include "OscSlip.h"
 #include <stddef.h> // size_t, NULL
+#include <stdint.h> // uint32_t, uintptr_t
+#include <string.h> // memcpy
 
 //------------------------------------------------------------------------------
 // Definitions
@@ -20,6 +22,17 @@
 #define SLIP_ESC_END (char)0xDC
 #define SLIP_ESC_ESC (char)0xDD
 
+/**
+ * @brief Evaluates to non-zero if any byte of a 32-bit word is zero.
+ */
+#define HAS_ZERO_BYTE(word) (((word) - 0x01010101ul) & ~(word) & 0x80808080ul)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static size_t GetRunSize(const char* const source, const size_t sourceSize);
+static void AppendBytes(OscSlipDecoder * const oscSlipDecoder, const char* const source, const size_t numberOfBytes);
+
 //------------------------------------------------------------------------------
 // Functions
 
@@ -45,19 +58,18 @@
  * @param oscSlipDecoder Address OSC SLIP decoder structure.
  */
 void OscSlipDecoderInitialise(OscSlipDecoder * const oscSlipDecoder) {
-    oscSlipDecoder->bufferIndex = 0;
+    OscPacketInitialise(&oscSlipDecoder->oscPacket);
+    oscSlipDecoder->isEscaped = false;
+    oscSlipDecoder->isDiscarding = false;
     oscSlipDecoder->processPacket = NULL;
 }
 
 /**
  * @brief Processes byte received within serial stream.
  *
- * This function should be called for each consecutive byte received within a
- * serial stream.  Each byte is added to SLIP decode receive buffer.  If the
- * received byte is the last byte of a SLIP packet then the SLIP packet is
- * decoded and parsed to the application as an OSC packet via the ProcessPacket
- * function.  The decoded packet will be discarded if a ProcessPacket function
- * has not been assigned.
+ * This function is equivalent to calling OscSlipDecoderProcessBytes with a
+ * single byte.  OscSlipDecoderProcessBytes should be used where multiple bytes
+ * are available.
  *
  * Example use:
  * @code
@@ -71,47 +83,178 @@ void OscSlipDecoderInitialise(OscSlipDecoder * const oscSlipDecoder) {
  * @return 0 if successful.
  */
 int OscSlipDecoderProcessByte(OscSlipDecoder * const oscSlipDecoder, const char byte) {
+    return OscSlipDecoderProcessBytes(oscSlipDecoder, &byte, 1);
+}
 
-    // Add byte to buffer
-    oscSlipDecoder->buffer[oscSlipDecoder->bufferIndex] = byte;
+/**
+ * @brief Processes bytes received within serial stream.
+ *
+ * This function should be called for each consecutive block of bytes received
+ * within a serial stream.  The block may be of any size and SLIP packets may
+ * span multiple blocks.  Bytes are decoded directly into the OSC packet of the
+ * decoder.  Each complete SLIP packet is parsed to the application as an OSC
+ * packet via the ProcessPacket function.  Empty SLIP packets are ignored.
+ *
+ * A SLIP packet that decodes to more than MAX_OSC_PACKET_SIZE bytes, or that
+ * contains an invalid escape sequence, is discarded and an error is returned.
+ * An error is also returned if a complete SLIP packet is received and a
+ * ProcessPacket function has not been assigned.  Remaining bytes are always
+ * processed.
+ *
+ * Example use:
+ * @code
+ * char bytes[64];
+ * const size_t numberOfBytes = MySerialRead(bytes, sizeof(bytes));
+ * OscSlipDecoderProcessBytes(&oscSlipDecoder, bytes, numberOfBytes);
+ * @endcode
+ *
+ * @param oscSlipDecoder Address OSC SLIP decoder structure.
+ * @param source Address of bytes received within serial stream.
+ * @param sourceSize Number of bytes.
+ * @return 0 if successful.
+ */
+int OscSlipDecoderProcessBytes(OscSlipDecoder * const oscSlipDecoder, const char* const source, const size_t sourceSize) {
+    int error = 0;
+    size_t sourceIndex = 0;
+    while (sourceIndex < sourceSize) {
 
-    // Increment index with overflow
-    if (++oscSlipDecoder->bufferIndex >= OSC_SLIP_DECODER_BUFFER_SIZE) {
-        oscSlipDecoder->bufferIndex = 0;
-    }
+        // Decode second byte of escape sequence
+        if (oscSlipDecoder->isEscaped == true) {
+            oscSlipDecoder->isEscaped = false;
+            static const char slipEnd = SLIP_END;
+            static const char slipEsc = SLIP_ESC;
+            switch (source[sourceIndex]) {
+                case SLIP_ESC_END:
+                    AppendBytes(oscSlipDecoder, &slipEnd, 1);
+                    sourceIndex++;
+                    break;
+                case SLIP_ESC_ESC:
+                    AppendBytes(oscSlipDecoder, &slipEsc, 1);
+                    sourceIndex++;
+                    break;
+                default:
+                    oscSlipDecoder->isDiscarding = true; // byte not consumed in case it is SLIP_END
+                    error = 1; // error: unexpected byte value
+                    break;
+            }
+            continue;
+        }
 
-    // Decode packet if END byte
-    if (byte == SLIP_END) {
-        oscSlipDecoder->bufferIndex = 0;
-        if (oscSlipDecoder->processPacket == NULL) {
-            return 1; // error: user function undefined
+        // Copy bytes that require no decoding
+        const size_t runSize = GetRunSize(&source[sourceIndex], sourceSize - sourceIndex);
+        AppendBytes(oscSlipDecoder, &source[sourceIndex], runSize);
+        sourceIndex += runSize;
+        if (sourceIndex >= sourceSize) {
+            break;
         }
-        OscPacket oscPacket;
-        OscPacketInitialise(&oscPacket);
-        int i = 0;
-        while (oscSlipDecoder->buffer[i] != SLIP_END) {
-            if (oscSlipDecoder->buffer[i] == SLIP_ESC) {
-                switch (oscSlipDecoder->buffer[++i]) {
-                    case SLIP_ESC_END:
-                        oscPacket.contents[oscPacket.size++] = SLIP_END;
-                        break;
-                    case SLIP_ESC_ESC:
-                        oscPacket.contents[oscPacket.size++] = SLIP_ESC;
-                        break;
-                    default:
-                        return 1; // error: unexpected byte value
-                }
+
+        // Process SLIP_ESC or SLIP_END
+        if (source[sourceIndex++] == SLIP_ESC) {
+            oscSlipDecoder->isEscaped = true;
+            continue;
+        }
+        if (oscSlipDecoder->isDiscarding == true) {
+            error = 1; // error: packet truncated or invalid
+        } else if (oscSlipDecoder->oscPacket.size > 0) {
+            if (oscSlipDecoder->processPacket == NULL) {
+                error = 1; // error: user function undefined
             } else {
-                oscPacket.contents[oscPacket.size++] = oscSlipDecoder->buffer[i];
-            }
-            if (oscPacket.size > MAX_OSC_PACKET_SIZE) {
-                return 1; // error: decoded packet too large
+                oscSlipDecoder->processPacket(&oscSlipDecoder->oscPacket);
             }
-            i++;
         }
-        oscSlipDecoder->processPacket(&oscPacket);
+        oscSlipDecoder->oscPacket.size = 0;
+        oscSlipDecoder->isDiscarding = false;
     }
-    return 0;
+    return error;
+}
+
+/**
+ * @brief Initialises an OSC SLIP encoder structure.
+ *
+ * An OSC SLIP encoder structure must be initialised before use.  The source is
+ * not copied and so must remain valid until encoding is complete.
+ *
+ * Example use:
+ * @code
+ * OscSlipEncoder oscSlipEncoder;
+ * OscSlipEncoderInitialise(&oscSlipEncoder, oscPacket.contents, oscPacket.size);
+ * @endcode
+ *
+ * @param oscSlipEncoder Address OSC SLIP encoder structure.
+ * @param source Address of OSC packet contents to be encoded.
+ * @param sourceSize Size of OSC packet contents.
+ */
+void OscSlipEncoderInitialise(OscSlipEncoder * const oscSlipEncoder, const char* const source, const size_t sourceSize) {
+    oscSlipEncoder->source = source;
+    oscSlipEncoder->sourceSize = sourceSize;
+    oscSlipEncoder->sourceIndex = 0;
+    oscSlipEncoder->isEscaped = false;
+    oscSlipEncoder->isComplete = false;
+}
+
+/**
+ * @brief Writes the next block of the SLIP packet.
+ *
+ * This function should be called repeatedly until OscSlipEncoderIsComplete
+ * returns true.  Each call writes as many bytes as fit within the destination.
+ *
+ * Example use:
+ * @code
+ * while(OscSlipEncoderIsComplete(&oscSlipEncoder) == false) {
+ *     char block[64];
+ *     const size_t blockSize = OscSlipEncoderWrite(&oscSlipEncoder, block, sizeof(block));
+ *     MySerialWrite(block, blockSize);
+ * }
+ * @endcode
+ *
+ * @param oscSlipEncoder Address OSC SLIP encoder structure.
+ * @param destination Destination address of the block.
+ * @param destinationSize Size of the destination.
+ * @return Number of bytes written to the destination.
+ */
+size_t OscSlipEncoderWrite(OscSlipEncoder * const oscSlipEncoder, char* const destination, const size_t destinationSize) {
+    size_t destinationIndex = 0;
+    while ((destinationIndex < destinationSize) && (oscSlipEncoder->isComplete == false)) {
+
+        // Write second byte of escape sequence
+        if (oscSlipEncoder->isEscaped == true) {
+            oscSlipEncoder->isEscaped = false;
+            destination[destinationIndex++] = oscSlipEncoder->source[oscSlipEncoder->sourceIndex++] == SLIP_END ? SLIP_ESC_END : SLIP_ESC_ESC;
+            continue;
+        }
+
+        // Write SLIP_END after last byte
+        if (oscSlipEncoder->sourceIndex >= oscSlipEncoder->sourceSize) {
+            destination[destinationIndex++] = SLIP_END;
+            oscSlipEncoder->isComplete = true;
+            break;
+        }
+
+        // Copy bytes that require no encoding
+        size_t runSize = GetRunSize(&oscSlipEncoder->source[oscSlipEncoder->sourceIndex], oscSlipEncoder->sourceSize - oscSlipEncoder->sourceIndex);
+        if (runSize > (destinationSize - destinationIndex)) {
+            runSize = destinationSize - destinationIndex;
+        }
+        memcpy(&destination[destinationIndex], &oscSlipEncoder->source[oscSlipEncoder->sourceIndex], runSize);
+        destinationIndex += runSize;
+        oscSlipEncoder->sourceIndex += runSize;
+
+        // Write first byte of escape sequence
+        if ((destinationIndex < destinationSize) && (oscSlipEncoder->sourceIndex < oscSlipEncoder->sourceSize)) {
+            destination[destinationIndex++] = SLIP_ESC;
+            oscSlipEncoder->isEscaped = true;
+        }
+    }
+    return destinationIndex;
+}
+
+/**
+ * @brief Returns true if the complete SLIP packet has been written.
+ * @param oscSlipEncoder Address OSC SLIP encoder structure.
+ * @return true if the complete SLIP packet has been written.
+ */
+bool OscSlipEncoderIsComplete(const OscSlipEncoder * const oscSlipEncoder) {
+    return oscSlipEncoder->isComplete;
 }
 
 /**
@@ -136,29 +279,71 @@ int OscSlipDecoderProcessByte(OscSlipDecoder * const oscSlipDecoder, const char
  */
 int OscSlipEncodePacket(const OscPacket * const oscPacket, size_t * const slipPacketSize, char* const destination, const size_t destinationSize) {
     *slipPacketSize = 0; // size will be 0 if function unsuccessful
-    int encodedPacketSize = 0;
-    int packetIndex;
-    for (packetIndex = 0; packetIndex < oscPacket->size; packetIndex++) {
-        if (encodedPacketSize + 1 > destinationSize) {
-            return 1; // error: destination too small
-        }
-        switch (oscPacket->contents[packetIndex]) {
-            case SLIP_END:
-                destination[encodedPacketSize++] = SLIP_ESC;
-                destination[encodedPacketSize++] = SLIP_ESC_END;
-                break;
-            case SLIP_ESC:
-                destination[encodedPacketSize++] = SLIP_ESC;
-                destination[encodedPacketSize++] = SLIP_ESC_ESC;
-                break;
-            default:
-                destination[encodedPacketSize++] = oscPacket->contents[packetIndex];
-        }
+    OscSlipEncoder oscSlipEncoder;
+    OscSlipEncoderInitialise(&oscSlipEncoder, oscPacket->contents, oscPacket->size);
+    const size_t encodedPacketSize = OscSlipEncoderWrite(&oscSlipEncoder, destination, destinationSize);
+    if (OscSlipEncoderIsComplete(&oscSlipEncoder) == false) {
+        return 1; // error: destination too small
     }
-    destination[encodedPacketSize++] = SLIP_END;
     *slipPacketSize = encodedPacketSize;
     return 0;
 }
 
+/**
+ * @brief Returns the number of bytes before the first SLIP_END or SLIP_ESC.
+ *
+ * Bytes are tested a 32-bit word at a time once the source is word-aligned.
+ * This is an internal function and cannot be called by the user application.
+ *
+ * @param source Address of bytes.
+ * @param sourceSize Number of bytes.
+ * @return Number of bytes before the first SLIP_END or SLIP_ESC, or sourceSize
+ * if neither is present.
+ */
+static size_t GetRunSize(const char* const source, const size_t sourceSize) {
+    size_t index = 0;
+    while ((index < sourceSize) && ((((uintptr_t) & source[index]) % sizeof (uint32_t)) != 0)) {
+        if ((source[index] == SLIP_END) || (source[index] == SLIP_ESC)) {
+            return index;
+        }
+        index++;
+    }
+    while ((index + sizeof (uint32_t)) <= sourceSize) {
+        uint32_t word;
+        memcpy(&word, &source[index], sizeof (uint32_t)); // aligned so compiles to single load
+        if ((HAS_ZERO_BYTE(word ^ 0xC0C0C0C0ul) | HAS_ZERO_BYTE(word ^ 0xDBDBDBDBul)) != 0) {
+            break; // word contains SLIP_END or SLIP_ESC
+        }
+        index += sizeof (uint32_t);
+    }
+    while (index < sourceSize) {
+        if ((source[index] == SLIP_END) || (source[index] == SLIP_ESC)) {
+            return index;
+        }
+        index++;
+    }
+    return sourceSize;
+}
+
+/**
+ * @brief Appends decoded bytes to the OSC packet of the decoder.  The SLIP
+ * packet is marked for discarding if the OSC packet would overflow.  This is
+ * an internal function and cannot be called by the user application.
+ * @param oscSlipDecoder Address OSC SLIP decoder structure.
+ * @param source Address of decoded bytes.
+ * @param numberOfBytes Number of decoded bytes.
+ */
+static void AppendBytes(OscSlipDecoder * const oscSlipDecoder, const char* const source, const size_t numberOfBytes) {
+    if (oscSlipDecoder->isDiscarding == true) {
+        return;
+    }
+    if ((oscSlipDecoder->oscPacket.size + numberOfBytes) > oscSlipDecoder->oscPacket.maxSize) {
+        oscSlipDecoder->isDiscarding = true; // packet truncated
+        return;
+    }
+    memcpy(&oscSlipDecoder->oscPacket.contents[oscSlipDecoder->oscPacket.size], source, numberOfBytes);
+    oscSlipDecoder->oscPacket.size += numberOfBytes;
+}
+
 //------------------------------------------------------------------------------
 // End of file
@@ -3,6 +3,12 @@
  * @author Seb Madgwick
  * @brief Functions and structures for encoding and decoding OSC packets using
  * the SLIP protocol.
+ *
+ * The decoder and encoder both operate on arbitrary sized blocks of bytes so
+ * that a serial stream may be processed in whatever chunks the transport
+ * provides.  Runs of bytes that require no escaping are located a 32-bit word
+ * at a time and copied as a block.
+ *
  * @see http://en.wikipedia.org/wiki/Serial_Line_Internet_Protocol
  */
 
@@ -13,31 +19,46 @@
 // Includes
 
 #include "OscPacket.h"
+#include <stdbool.h> // bool, true, false
+#include <stddef.h> // size_t
 
 //------------------------------------------------------------------------------
 // Definitions
 
-/**
- * @brief OSC SLIP decoder buffer size.  If a packet size exceeds the buffer
- * size then the packet will be truncated with the oldest bytes discarded.
- */
-#define OSC_SLIP_DECODER_BUFFER_SIZE MAX_TRANSPORT_SIZE
-
 /**
  * @brief OSC SLIP decoder structure.  Must be initialised using
- * OscSlipDecoderInitialise.
+ * OscSlipDecoderInitialise.  Bytes are decoded directly into the OSC packet as
+ * they are received.  A SLIP packet that decodes to more than
+ * MAX_OSC_PACKET_SIZE bytes is discarded.
  */
 typedef struct {
-    char buffer[OSC_SLIP_DECODER_BUFFER_SIZE];
-    int bufferIndex;
+    OscPacket oscPacket;
+    bool isEscaped; // previous byte was SLIP_ESC
+    bool isDiscarding; // current SLIP packet truncated or invalid
     void (*processPacket)(OscPacket * const oscPacket);
 } OscSlipDecoder;
 
+/**
+ * @brief OSC SLIP encoder structure.  Must be initialised using
+ * OscSlipEncoderInitialise.
+ */
+typedef struct {
+    const char* source;
+    size_t sourceSize;
+    size_t sourceIndex;
+    bool isEscaped; // second byte of escape sequence not yet written
+    bool isComplete; // SLIP_END written
+} OscSlipEncoder;
+
 //------------------------------------------------------------------------------
 // Function prototypes
 
 void OscSlipDecoderInitialise(OscSlipDecoder * const oscSlipDecoder);
 int OscSlipDecoderProcessByte(OscSlipDecoder * const oscSlipDecoder, const char byte);
+int OscSlipDecoderProcessBytes(OscSlipDecoder * const oscSlipDecoder, const char* const source, const size_t sourceSize);
+void OscSlipEncoderInitialise(OscSlipEncoder * const oscSlipEncoder, const char* const source, const size_t sourceSize);
+size_t OscSlipEncoderWrite(OscSlipEncoder * const oscSlipEncoder, char* const destination, const size_t destinationSize);
+bool OscSlipEncoderIsComplete(const OscSlipEncoder * const oscSlipEncoder);
 int OscSlipEncodePacket(const OscPacket * const oscPacket, size_t * const slipPacketSize, char* const destination, const size_t destinationSize);
 
 #endif
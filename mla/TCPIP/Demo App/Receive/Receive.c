@@ -0,0 +1,328 @@
+/**
+ * @file Receive.c
+ * @author Seb Madgwick
+ * @brief Application tasks and functions for receiving messages.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Ethernet/Ethernet.h"
+#include "Osc99/Osc99.h"
+#include "Receive.h"
+#include "Scheduler/Scheduler.h"
+#include "Send/Send.h"
+#include "Subscribers/Subscribers.h"
+#include <stdbool.h> // bool, true, false
+#include "Synchronisation/Synchronisation.h"
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of packets processed by each call to ReceiveDoTasks.
+ * Packets are received in bursts when many slaves send delay requests at the
+ * same time.  Packets not processed remain in the MAC receive buffers until
+ * the next call.  This value may be modified as required by the user
+ * application.
+ */
+#define MAX_PACKETS_PER_CALL 16
+
+/**
+ * @brief Maximum number of delay responses waiting for a transmit buffer.
+ * Delay requests received while the queue is full are not replied to.  This
+ * value may be modified as required by the user application.
+ */
+#define DELAY_RESPONSE_QUEUE_SIZE MAX_PACKETS_PER_CALL
+
+/**
+ * @brief Delay response waiting for a transmit buffer.
+ */
+typedef struct {
+    EthernetEndpoint sender;
+    OscTimeTag originTimeTag;
+    bool isOriginAvailable;
+    OscTimeTag receiveTimeTag;
+} DelayResponse;
+
+/**
+ * @brief Context passed to each OSC address method.
+ */
+typedef struct {
+    OscMessageView* oscMessageView;
+    Ticks64 ticks64; // time of arrival, or time of execution if scheduled
+    bool isReplyAvailable; // true if the method may reply to the sender
+} MessageContext;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void ProcessPacket(const char* const source, const size_t sourceSize, const Ticks64 timeOfArrival);
+static void ProcessScheduledMessage(const Ticks64 ticks64, OscMessageView * const oscMessageView);
+static void DelayRequest(void* const context);
+static void SendDelayResponses();
+static void SynchronisationRate(void* const context);
+static void SynchronisationBurst(void* const context);
+static void Subscribe(void* const context);
+static void Unsubscribe(void* const context);
+static int GetSubscriber(MessageContext * const messageContext, EthernetEndpoint * const endpoint);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static OscAddressDispatcher oscAddressDispatcher;
+static OscMessageTemplate delayResponseMessage;
+static OscMessageTemplate delayResponseMessageWithoutOrigin;
+static DelayResponse delayResponses[DELAY_RESPONSE_QUEUE_SIZE];
+static size_t delayResponseIndex; // index of oldest delay response
+static size_t numberOfDelayResponses;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once on system
+ * start up.
+ */
+void ReceiveInitialise() {
+    OscAddressDispatcherInitialise(&oscAddressDispatcher);
+    OscAddressDispatcherAddMethod(&oscAddressDispatcher, "/delay_req", DelayRequest);
+    OscAddressDispatcherAddMethod(&oscAddressDispatcher, "/sync_rate", SynchronisationRate);
+    OscAddressDispatcherAddMethod(&oscAddressDispatcher, "/sync_burst", SynchronisationBurst);
+    OscAddressDispatcherAddMethod(&oscAddressDispatcher, "/subscribe", Subscribe);
+    OscAddressDispatcherAddMethod(&oscAddressDispatcher, "/unsubscribe", Unsubscribe);
+    OscMessageTemplateInitialise(&delayResponseMessage, "/delay_resp", ",ttt");
+    OscMessageTemplateInitialise(&delayResponseMessageWithoutOrigin, "/delay_resp", ",tt");
+    SchedulerInitialise(ProcessScheduledMessage);
+}
+
+/**
+ * @brief Do tasks.  This function should be called repeatedly within the main
+ * program loop.
+ */
+void ReceiveDoTasks() {
+    SendDelayResponses();
+    int packetCount;
+    for (packetCount = 0; packetCount < MAX_PACKETS_PER_CALL; packetCount++) {
+        static char source[MAX_OSC_PACKET_SIZE];
+        Ticks64 timeOfArrival;
+        const size_t sourceSize = EthernetGet(source, sizeof (source), &timeOfArrival);
+        if (sourceSize == 0) {
+            break; // no more packets
+        }
+        ProcessPacket(source, sourceSize, timeOfArrival);
+    }
+}
+
+/**
+ * @brief Processes received packet.
+ *
+ * OSC messages are dispatched immediately with the time of arrival so that
+ * methods may reply to the sender.  OSC bundles are passed to the scheduler.
+ *
+ * @param source Address of packet.
+ * @param sourceSize Size of packet.
+ * @param timeOfArrival Time of arrival of packet.
+ */
+static void ProcessPacket(const char* const source, const size_t sourceSize, const Ticks64 timeOfArrival) {
+    if (OSC_CONTENTS_IS_MESSAGE(source) == false) {
+        SchedulerAddPacket(source, sourceSize);
+        return;
+    }
+    OscMessageView oscMessageView;
+    if (OscMessageViewInitialise(&oscMessageView, source, sourceSize) != 0) {
+        return; // error: invalid message
+    }
+    MessageContext messageContext;
+    messageContext.oscMessageView = &oscMessageView;
+    messageContext.ticks64 = timeOfArrival;
+    messageContext.isReplyAvailable = true;
+    OscAddressDispatcherDispatch(&oscAddressDispatcher, oscMessageView.oscAddressPattern, &messageContext);
+}
+
+/**
+ * @brief Processes OSC message contained within an OSC bundle.  This function
+ * may be called from the scheduler interrupt and so methods may not reply to
+ * the sender.
+ * @param ticks64 Time of execution.
+ * @param oscMessageView Address of OSC message view.
+ */
+static void ProcessScheduledMessage(const Ticks64 ticks64, OscMessageView * const oscMessageView) {
+    MessageContext messageContext;
+    messageContext.oscMessageView = oscMessageView;
+    messageContext.ticks64 = ticks64;
+    messageContext.isReplyAvailable = false;
+    OscAddressDispatcherDispatch(&oscAddressDispatcher, oscMessageView->oscAddressPattern, &messageContext);
+}
+
+/**
+ * @brief Replies to a delay request with a delay response.
+ *
+ * A delay request is an OSC message with the address "/delay_req" and an
+ * optional time tag argument indicating the time it was sent by the slave.
+ * The delay response is an OSC message with the address "/delay_resp" and the
+ * time tag arguments: the time the request was sent (if provided), the time
+ * the request was received by the master, and the time the response was sent
+ * by the master.  The slave may then calculate the path delay and clock offset
+ * in the same way as NTP and the PTP delay request-response mechanism.
+ *
+ * The delay response is queued and sent by SendDelayResponses.
+ *
+ * The transmit time is a software timestamp obtained immediately before the
+ * delay response is written to the MAC rather than the time of transmission
+ * captured by the Ethernet TX done interrupt.  The transmit time must be
+ * within the delay response itself and the MAC holds only one prepared packet,
+ * which is reserved for synchronisation messages.  The transmit time is
+ * therefore earlier than the time of transmission by the time to calculate the
+ * UDP checksum and write the frame to the MAC, a few microseconds, plus the
+ * time to transmit any frames already queued in the MAC transmit buffers.  A
+ * slave will calculate a path delay that is longer by this bias and so will
+ * synchronise to half of this bias behind the master.  The queueing part of
+ * the bias varies between delay responses and so is rejected by a slave that
+ * uses only the delay responses with the least path delay.
+ *
+ * @param context Address of message context.
+ */
+static void DelayRequest(void* const context) {
+    MessageContext* const messageContext = context;
+    if (messageContext->isReplyAvailable == false) {
+        return; // error: scheduled delay request cannot be replied to
+    }
+    if (numberOfDelayResponses >= DELAY_RESPONSE_QUEUE_SIZE) {
+        return; // error: delay response queue full
+    }
+    DelayResponse* const delayResponse = &delayResponses[(delayResponseIndex + numberOfDelayResponses) % DELAY_RESPONSE_QUEUE_SIZE];
+    EthernetGetSender(&delayResponse->sender);
+    delayResponse->isOriginAvailable = OscMessageViewGetTimeTag(messageContext->oscMessageView, &delayResponse->originTimeTag) == 0;
+    delayResponse->receiveTimeTag = SynchronisationTicksToOscTimeTag(messageContext->ticks64);
+    numberOfDelayResponses++;
+    SendDelayResponses();
+}
+
+/**
+ * @brief Sends the queued delay responses in the order that the delay requests
+ * were received.
+ *
+ * Sending stops at the first delay response for which a transmit buffer is not
+ * available and is resumed by the next call to ReceiveDoTasks so that the main
+ * program loop never waits for the MAC.  The transmit time is obtained each
+ * time a delay response is sent and so is not affected by the time spent in
+ * the queue.  The queue is abandoned if the link is down.
+ */
+static void SendDelayResponses() {
+    while (numberOfDelayResponses > 0) {
+        if (EthernetIsLinked() == false) {
+            numberOfDelayResponses = 0;
+            return; // error: no link
+        }
+        const DelayResponse * const delayResponse = &delayResponses[delayResponseIndex];
+        OscMessageTemplate* oscMessageTemplate = &delayResponseMessageWithoutOrigin;
+        int argumentNumber = 0;
+        if (delayResponse->isOriginAvailable == true) {
+            oscMessageTemplate = &delayResponseMessage;
+            OscMessageTemplateSetTimeTag(oscMessageTemplate, argumentNumber++, delayResponse->originTimeTag);
+        }
+        OscMessageTemplateSetTimeTag(oscMessageTemplate, argumentNumber++, delayResponse->receiveTimeTag);
+        OscMessageTemplateSetTimeTag(oscMessageTemplate, argumentNumber, SynchronisationTicksToOscTimeTag(TimerGetTicks64()));
+        size_t numberOfEndpointsSent;
+        if (EthernetUnicastToEach(&delayResponse->sender, 1, oscMessageTemplate->contents, oscMessageTemplate->size, &numberOfEndpointsSent) != 0) {
+            return; // error: transmit buffer not available
+        }
+        delayResponseIndex = (delayResponseIndex + 1) % DELAY_RESPONSE_QUEUE_SIZE;
+        numberOfDelayResponses--;
+    }
+}
+
+/**
+ * @brief Sets the steady-state synchronisation message rate.  The OSC message
+ * has the address "/sync_rate" and an int32 argument indicating the rate in
+ * messages per second.
+ * @param context Address of message context.
+ */
+static void SynchronisationRate(void* const context) {
+    MessageContext* const messageContext = context;
+    int32_t rate;
+    if (OscMessageViewGetInt32(messageContext->oscMessageView, &rate) != 0) {
+        return; // error: invalid argument
+    }
+    SendSetSynchronisationRate(rate);
+}
+
+/**
+ * @brief Starts a burst of synchronisation messages.  The OSC message has the
+ * address "/sync_burst" and no arguments.  A slave may request a burst when
+ * its servo must converge quickly, for example after start up.
+ * @param context Address of message context.
+ */
+static void SynchronisationBurst(void* const context) {
+    SendStartSynchronisationBurst();
+}
+
+/**
+ * @brief Subscribes the sender to external clock edge timestamps.  The OSC
+ * message has the address "/subscribe" and an optional int32 argument
+ * indicating the lease in seconds, followed by an optional int32 argument
+ * indicating the port to send to.  SUBSCRIBERS_DEFAULT_LEASE is used if no
+ * lease is provided and the source port of the message is used if no port is
+ * provided.  The subscription must be renewed before the lease expires.
+ * @param context Address of message context.
+ */
+static void Subscribe(void* const context) {
+    MessageContext* const messageContext = context;
+    int32_t lease = SUBSCRIBERS_DEFAULT_LEASE;
+    if (OscMessageViewIsArgumentAvailable(messageContext->oscMessageView) == true) {
+        if (OscMessageViewGetInt32(messageContext->oscMessageView, &lease) != 0) {
+            return; // error: invalid argument
+        }
+    }
+    EthernetEndpoint endpoint;
+    if (GetSubscriber(messageContext, &endpoint) != 0) {
+        return; // error: invalid subscriber
+    }
+    SubscribersAdd(&endpoint, lease);
+}
+
+/**
+ * @brief Unsubscribes the sender from external clock edge timestamps.  The OSC
+ * message has the address "/unsubscribe" and an optional int32 argument
+ * indicating the port that was subscribed.  The source port of the message is
+ * used if no port is provided.
+ * @param context Address of message context.
+ */
+static void Unsubscribe(void* const context) {
+    MessageContext* const messageContext = context;
+    EthernetEndpoint endpoint;
+    if (GetSubscriber(messageContext, &endpoint) != 0) {
+        return; // error: invalid subscriber
+    }
+    SubscribersRemove(&endpoint);
+}
+
+/**
+ * @brief Gets the subscriber endpoint from the sender of the message and the
+ * optional int32 port argument.
+ * @param messageContext Address of message context.
+ * @param endpoint Address where the endpoint will be written.
+ * @return 0 if successful.
+ */
+static int GetSubscriber(MessageContext * const messageContext, EthernetEndpoint * const endpoint) {
+    if (messageContext->isReplyAvailable == false) {
+        return 1; // error: sender of scheduled message not known
+    }
+    EthernetGetSender(endpoint);
+    if (OscMessageViewIsArgumentAvailable(messageContext->oscMessageView) == true) {
+        int32_t port;
+        if (OscMessageViewGetInt32(messageContext->oscMessageView, &port) != 0) {
+            return 1; // error: invalid argument
+        }
+        if ((port <= 0) || (port > 0xFFFF)) {
+            return 1; // error: invalid port
+        }
+        endpoint->port = port;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,289 @@
+/**
+ * @file Scheduler.c
+ * @author Seb Madgwick
+ * @brief Executes OSC messages contained within OSC bundles at the time
+ * indicated by the OSC time tag.
+ *
+ * Scheduled OSC messages are copied to a fixed-capacity pool and ordered by a
+ * binary min-heap so that insertion and removal are O(log n).  The core timer
+ * compare interrupt is armed for the earliest OSC message.  The interrupt fires
+ * shortly before the scheduled time and then waits for the exact timer tick so
+ * that the OSC message is executed with tick-level precision.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Scheduler.h"
+#include <stdbool.h> // true
+#include <stdint.h> // uint32_t, uint64_t
+#include <string.h> // memcpy
+#include "Synchronisation/Synchronisation.h"
+#include <xc.h>
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of OSC messages that may be scheduled.  This value may
+ * be modified as required by the user application.
+ */
+#define MAX_NUMBER_OF_SCHEDULED_MESSAGES 16
+
+/**
+ * @brief Maximum size (number of bytes) of a scheduled OSC message.  This value
+ * may be modified as required by the user application.
+ */
+#define MAX_SCHEDULED_MESSAGE_SIZE 128
+
+/**
+ * @brief Period (in timer ticks) before the scheduled time that the interrupt
+ * fires.  Must be greater than the worst-case interrupt latency.
+ */
+#define WAIT_TICKS (TIMER_TICKS_PER_SECOND / 100000) // 10 us
+
+/**
+ * @brief Maximum core timer period.  The core timer increments at half the
+ * system clock and so this is approximately 13 seconds.
+ */
+#define MAX_CORE_TIMER_PERIOD 0x20000000ul
+
+#define CT_IFSXCLR IFS0CLR
+#define CT_IFSXSET IFS0SET
+#define CT_IECXSET IEC0SET
+#define CT_IECXCLR IEC0CLR
+#define CT_INT_BIT (1 << 0)
+
+/**
+ * @brief Scheduled OSC message.
+ */
+typedef struct {
+    Ticks64 ticks64;
+    char contents[MAX_SCHEDULED_MESSAGE_SIZE];
+    size_t contentsSize;
+} ScheduledMessage;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static int Schedule(const Ticks64 ticks64, const OscMessageView * const oscMessageView);
+static void ProcessDueMessages();
+static void ArmInterrupt();
+static void SiftUp(int heapIndex);
+static void SiftDown(int heapIndex);
+static void Swap(const int heapIndexA, const int heapIndexB);
+
+//------------------------------------------------------------------------------
+// Variable declarations
+
+static void (*processMessage)(const Ticks64 ticks64, OscMessageView * const oscMessageView);
+static ScheduledMessage scheduledMessages[MAX_NUMBER_OF_SCHEDULED_MESSAGES];
+static int heap[MAX_NUMBER_OF_SCHEDULED_MESSAGES]; // indexes of scheduled messages ordered by time
+static volatile int heapSize;
+static int freeIndexes[MAX_NUMBER_OF_SCHEDULED_MESSAGES]; // indexes of unused scheduled messages
+static int numberOfFreeIndexes;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  This function should be called once on system
+ * start up.
+ * @param processMessage_ Function called to execute each OSC message.  The
+ * function is called from an interrupt for scheduled OSC messages.
+ */
+void SchedulerInitialise(void (*processMessage_)(const Ticks64 ticks64, OscMessageView * const oscMessageView)) {
+    CT_IECXCLR = CT_INT_BIT; // disable interrupt
+    processMessage = processMessage_;
+    heapSize = 0;
+    for (numberOfFreeIndexes = 0; numberOfFreeIndexes < MAX_NUMBER_OF_SCHEDULED_MESSAGES; numberOfFreeIndexes++) {
+        freeIndexes[numberOfFreeIndexes] = numberOfFreeIndexes;
+    }
+    IPC0bits.CTIP = 5; // set interrupt priority
+    CT_IFSXCLR = CT_INT_BIT; // clear interrupt flag
+}
+
+/**
+ * @brief Executes or schedules each OSC message within an OSC packet.
+ *
+ * OSC messages not contained within an OSC bundle, or with an OSC time tag of
+ * "immediately" or in the past, are executed before this function returns.
+ * Other OSC messages are copied and executed at the timer ticks value
+ * corresponding to the OSC time tag.
+ *
+ * @param source Address of the OSC packet contents.
+ * @param sourceSize Size of the OSC packet contents.
+ * @return 0 if successful.
+ */
+int SchedulerAddPacket(const char* const source, const size_t sourceSize) {
+    int error = 0;
+    OscPacketIterator oscPacketIterator;
+    OscPacketIteratorInitialise(&oscPacketIterator, source, sourceSize);
+    const OscTimeTag* oscTimeTag;
+    OscMessageView oscMessageView;
+    while (OscPacketNextMessage(&oscPacketIterator, &oscTimeTag, &oscMessageView) == 0) {
+        const Ticks64 currentTicks = TimerGetTicks64();
+        if ((oscTimeTag == NULL) || (oscTimeTag->value == 1)) { // time tag value of 1 indicates "immediately"
+            processMessage(currentTicks, &oscMessageView);
+            continue;
+        }
+        const Ticks64 ticks64 = SynchronisationOscTimeTagToTicks(*oscTimeTag);
+        if (ticks64.value <= currentTicks.value) {
+            processMessage(ticks64, &oscMessageView);
+            continue;
+        }
+        if (Schedule(ticks64, &oscMessageView) != 0) {
+            error = 1; // error: unable to schedule message
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Returns the number of OSC messages waiting to be executed.
+ * @return Number of OSC messages waiting to be executed.
+ */
+int SchedulerGetNumberOfScheduledMessages() {
+    return heapSize;
+}
+
+/**
+ * @brief Copies an OSC message to the pool and inserts it into the heap.
+ * @param ticks64 Timer ticks value when the OSC message is to be executed.
+ * @param oscMessageView Address of the OSC message view.
+ * @return 0 if successful.
+ */
+static int Schedule(const Ticks64 ticks64, const OscMessageView * const oscMessageView) {
+    const size_t contentsSize = (oscMessageView->arguments + oscMessageView->argumentsSize) - oscMessageView->oscAddressPattern;
+    if (contentsSize > MAX_SCHEDULED_MESSAGE_SIZE) {
+        return 1; // error: message too large
+    }
+    CT_IECXCLR = CT_INT_BIT; // disable interrupt while heap is modified
+    if (numberOfFreeIndexes == 0) {
+        ArmInterrupt();
+        return 1; // error: scheduler full
+    }
+    const int index = freeIndexes[--numberOfFreeIndexes];
+    scheduledMessages[index].ticks64 = ticks64;
+    memcpy(scheduledMessages[index].contents, oscMessageView->oscAddressPattern, contentsSize);
+    scheduledMessages[index].contentsSize = contentsSize;
+    heap[heapSize] = index;
+    SiftUp(heapSize++);
+    ArmInterrupt();
+    return 0;
+}
+
+/**
+ * @brief Executes each OSC message that is due.  An OSC message due within
+ * WAIT_TICKS is executed once the exact timer tick is reached.  This function
+ * must only be called from the interrupt.
+ */
+static void ProcessDueMessages() {
+    while (heapSize > 0) {
+        const int index = heap[0];
+        const Ticks64 ticks64 = scheduledMessages[index].ticks64;
+        if (ticks64.value > (TimerGetTicks64().value + WAIT_TICKS)) {
+            break; // earliest message not yet due
+        }
+        while (TimerGetTicks64().value < ticks64.value); // wait for exact timer tick
+
+        // Remove from heap
+        heap[0] = heap[--heapSize];
+        SiftDown(0);
+
+        // Execute message and return to pool
+        OscMessageView oscMessageView;
+        if (OscMessageViewInitialise(&oscMessageView, scheduledMessages[index].contents, scheduledMessages[index].contentsSize) == 0) {
+            processMessage(ticks64, &oscMessageView);
+        }
+        freeIndexes[numberOfFreeIndexes++] = index;
+    }
+}
+
+/**
+ * @brief Arms the core timer compare interrupt for the earliest OSC message, or
+ * disables the interrupt if no OSC messages are scheduled.
+ */
+static void ArmInterrupt() {
+    if (heapSize == 0) {
+        CT_IECXCLR = CT_INT_BIT; // disable interrupt
+        return;
+    }
+    const uint64_t ticks = scheduledMessages[heap[0]].ticks64.value;
+    const uint64_t currentTicks = TimerGetTicks64().value;
+    if (ticks <= (currentTicks + (2 * WAIT_TICKS))) {
+        CT_IFSXSET = CT_INT_BIT; // interrupt immediately as compare may be missed
+    } else {
+        uint64_t coreTimerPeriod = (ticks - currentTicks - WAIT_TICKS) / 2; // core timer increments at half the system clock
+        if (coreTimerPeriod > MAX_CORE_TIMER_PERIOD) {
+            coreTimerPeriod = MAX_CORE_TIMER_PERIOD; // interrupt will be rearmed
+        }
+        _CP0_SET_COMPARE(_CP0_GET_COUNT() + (uint32_t) coreTimerPeriod);
+    }
+    CT_IECXSET = CT_INT_BIT; // enable interrupt
+}
+
+/**
+ * @brief Moves heap element towards root until heap is ordered.
+ * @param heapIndex Heap index of element.
+ */
+static void SiftUp(int heapIndex) {
+    while (heapIndex > 0) {
+        const int parentIndex = (heapIndex - 1) / 2;
+        if (scheduledMessages[heap[parentIndex]].ticks64.value <= scheduledMessages[heap[heapIndex]].ticks64.value) {
+            break;
+        }
+        Swap(heapIndex, parentIndex);
+        heapIndex = parentIndex;
+    }
+}
+
+/**
+ * @brief Moves heap element away from root until heap is ordered.
+ * @param heapIndex Heap index of element.
+ */
+static void SiftDown(int heapIndex) {
+    while (true) {
+        const int leftIndex = (2 * heapIndex) + 1;
+        const int rightIndex = leftIndex + 1;
+        int smallestIndex = heapIndex;
+        if ((leftIndex < heapSize) && (scheduledMessages[heap[leftIndex]].ticks64.value < scheduledMessages[heap[smallestIndex]].ticks64.value)) {
+            smallestIndex = leftIndex;
+        }
+        if ((rightIndex < heapSize) && (scheduledMessages[heap[rightIndex]].ticks64.value < scheduledMessages[heap[smallestIndex]].ticks64.value)) {
+            smallestIndex = rightIndex;
+        }
+        if (smallestIndex == heapIndex) {
+            break;
+        }
+        Swap(heapIndex, smallestIndex);
+        heapIndex = smallestIndex;
+    }
+}
+
+/**
+ * @brief Swaps two heap elements.
+ * @param heapIndexA Heap index of first element.
+ * @param heapIndexB Heap index of second element.
+ */
+static void Swap(const int heapIndexA, const int heapIndexB) {
+    const int index = heap[heapIndexA];
+    heap[heapIndexA] = heap[heapIndexB];
+    heap[heapIndexB] = index;
+}
+
+//------------------------------------------------------------------------------
+// Functions - Interrupts
+
+/**
+ * @brief Core timer interrupt to execute scheduled OSC messages.
+ */
+void __attribute__((interrupt(), vector(_CORE_TIMER_VECTOR))) CoreTimerInterrupt() {
+    _CP0_SET_COMPARE(_CP0_GET_COUNT() + MAX_CORE_TIMER_PERIOD); // writing compare clears core timer interrupt request
+    CT_IFSXCLR = CT_INT_BIT; // clear interrupt flag
+    ProcessDueMessages();
+    ArmInterrupt();
+}
+
+//------------------------------------------------------------------------------
+// End of file
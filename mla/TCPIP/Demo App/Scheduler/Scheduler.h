@@ -0,0 +1,28 @@
+/**
+ * @file Scheduler.h
+ * @author Seb Madgwick
+ * @brief Executes OSC messages contained within OSC bundles at the time
+ * indicated by the OSC time tag.
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Osc99/Osc99.h"
+#include <stddef.h> // size_t
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void SchedulerInitialise(void (*processMessage)(const Ticks64 ticks64, OscMessageView * const oscMessageView));
+int SchedulerAddPacket(const char* const source, const size_t sourceSize);
+int SchedulerGetNumberOfScheduledMessages();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
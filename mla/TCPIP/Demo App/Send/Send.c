@@ -10,6 +10,8 @@
 #include "Ethernet/Ethernet.h"
 #include "Osc99/Osc99.h"
 #include "Send.h"
+#include <string.h> // memcpy
+#include "Subscribers/Subscribers.h"
 #include "Synchronisation/Synchronisation.h"
 #include "SystemDefinitions.h"
 #include "Timer/Timer.h"
@@ -18,10 +20,75 @@
 // Definitions
 
 /**
- * @breif Rate (messages per second) at which synchronisation messages are sent.
+ * @brief Steady-state rate (messages per second) at which synchronisation
+ * messages are sent.  The rate may be changed at runtime by
+ * SendSetSynchronisationRate.  This value may be modified as required by the
+ * user application.
  */
 #define SYNCHRONISATION_RATE 1
 
+/**
+ * @brief Maximum rate (messages per second) at which synchronisation messages
+ * may be sent.  A message must be prepared by the main program loop within
+ * each period.
+ */
+#define MAX_SYNCHRONISATION_RATE 1000
+
+/**
+ * @brief Rate (messages per second) at which synchronisation messages are sent
+ * during a burst.  A burst starts each time the link comes up, or when
+ * requested by a slave, so that slaves receive many samples while their servos
+ * converge.  This value may be modified as required by the user application.
+ */
+#define BURST_SYNCHRONISATION_RATE 100
+
+/**
+ * @brief Duration (in seconds) for which BURST_SYNCHRONISATION_RATE is
+ * maintained.  The period is then doubled each second until the steady-state
+ * rate is reached.  This value may be modified as required by the user
+ * application.
+ */
+#define BURST_DURATION 10
+
+/**
+ * @brief Uncomment to broadcast the send-path CPU usage within the OSC message
+ * "/sync_cpu" every CPU_USAGE_PERIOD.  This should only be enabled for
+ * development as the messages are broadcast to every host on the network.
+ */
+//#define CPU_USAGE_ENABLED
+
+/**
+ * @brief Period (in seconds) at which the send-path CPU usage is broadcast.
+ */
+#define CPU_USAGE_PERIOD 5
+
+/**
+ * @brief Uncomment to send synchronisation messages in two steps.  Each /sync
+ * message is followed by a /sync_followup message containing the time the
+ * /sync message was transmitted by the MAC.  Both messages contain the same
+ * sequence number so that slaves may replace the time tag of the /sync message
+ * and so remove the latency and jitter of the master's transmit path.
+ */
+//#define TWO_STEP_SYNCHRONISATION
+
+/**
+ * @brief Maximum time (in timer ticks) that the main program loop will wait
+ * for the /sync message to be transmitted before abandoning the
+ * /sync_followup message.  This must be longer than the time to transmit a
+ * full size packet at 10 Mbps (1.2 ms).
+ */
+#define FOLLOW_UP_TIMEOUT (TIMER_TICKS_PER_SECOND / 500) // 2 ms
+
+/**
+ * @brief Period (timer ticks) of synchronisation messages sent at a rate.
+ * Messages are sent when the timer value is a multiple of this period.
+ */
+#define SYNCHRONISATION_PERIOD(rate) (TIMER_TICKS_PER_SECOND / (rate))
+
+#define T3_IFSXCLR IFS0CLR
+#define T3_IECXSET IEC0SET
+#define T3_INT_BIT (1 << 12)
+
 #define CN_IFSXCLR IFS1CLR
 #define CN_IECXSET IEC1SET
 #define CN_IECXCLR IEC1CLR
@@ -30,14 +97,46 @@
 //------------------------------------------------------------------------------
 // Function prototypes
 
-static void BroadcastSynchronisationMessage();
-static void UnicastExternalClockTimestamp();
+static void UpdateSynchronisationPeriod();
+static void StartSynchronisationTimer(const Ticks32 period);
+static void PrepareSynchronisationMessage();
+#ifdef TWO_STEP_SYNCHRONISATION
+static int BroadcastSynchronisationFollowUpMessage();
+#endif
+#ifdef CPU_USAGE_ENABLED
+static void BroadcastCpuUsage();
+#endif
+static int BroadcastMessageTemplate(const OscMessageTemplate * const oscMessageTemplate);
+static void SendExternalClockTimestamp();
+static void ResumeExternalClockTimestamp();
 
 //------------------------------------------------------------------------------
 // Variables
 
 volatile static Ticks64 externalTriggerTimestamp;
 volatile static bool externalTriggerState;
+static char externalClockBundle[64];
+static size_t externalClockBundleSize; // 0 if OSC bundle not being sent to subscribers
+static size_t externalClockSubscriberIndex; // index of next subscriber
+static OscMessageTemplate synchronisationMessage;
+static int32_t sequenceNumber;
+static uint32_t sentNumberOfSteps;
+volatile static bool isSynchronisationPrepared;
+volatile static bool isSynchronisationSent;
+static Ticks32 synchronisationPeriod;
+volatile static Ticks32 steadyPeriod = SYNCHRONISATION_PERIOD(SYNCHRONISATION_RATE);
+volatile static bool isBurstRequested;
+static Ticks32 burstPeriod; // 0 if no burst
+static Ticks32 burstStepTicks;
+#ifdef CPU_USAGE_ENABLED
+volatile static Ticks32 interruptTicks; // total ticks spent in Timer3Interrupt
+static Ticks32 taskTicks; // ticks spent in SendDoTasks since last CPU usage broadcast
+static OscMessageTemplate cpuUsageMessage;
+#endif
+static Ticks32 followUpTicks; // 0 if no follow-up message pending
+#ifdef TWO_STEP_SYNCHRONISATION
+static OscMessageTemplate synchronisationFollowUpMessage;
+#endif
 
 //------------------------------------------------------------------------------
 // Functions
@@ -50,11 +149,19 @@ volatile static bool externalTriggerState;
  * change notification interrupt.
  */
 void SendInitialise() {
+    OscMessageTemplateInitialise(&synchronisationMessage, "/sync", ",tiiiF");
+#ifdef TWO_STEP_SYNCHRONISATION
+    OscMessageTemplateInitialise(&synchronisationFollowUpMessage, "/sync_followup", ",ti");
+#endif
+#ifdef CPU_USAGE_ENABLED
+    OscMessageTemplateInitialise(&cpuUsageMessage, "/sync_cpu", ",if");
+#endif
     EXTERNAL_CLOCK_CNEN = 1;
     CNCONbits.ON = 1;
     IPC6bits.CNIP = 6;
     CN_IFSXCLR = CN_INT_BIT; // clear interrupt flag
     CN_IECXSET = CN_INT_BIT; // enable interrupt
+    StartSynchronisationTimer(steadyPeriod);
 }
 
 /**
@@ -63,19 +170,33 @@ void SendInitialise() {
  */
 void SendDoTasks() {
 
-    // Broadcast synchronisation message
+    // Update synchronisation rate
     static Ticks32 ledTicks = 0;
     const Ticks32 currentTicks = TimerGetTicks32();
-    static Ticks32 previousTicks;
-    if ((currentTicks - previousTicks) >= (TIMER_TICKS_PER_SECOND / SYNCHRONISATION_RATE)) {
-        previousTicks = currentTicks;
-        BroadcastSynchronisationMessage();
+    UpdateSynchronisationPeriod();
+
+    // Complete synchronisation message sent by interrupt
+    if (isSynchronisationSent == true) {
+#ifdef TWO_STEP_SYNCHRONISATION
+        followUpTicks = currentTicks;
+        if (followUpTicks == 0) {
+            followUpTicks = 1; // value cannot be zero as this would indicate that no follow-up message is pending
+        }
+#endif
+        isSynchronisationSent = false;
         LED3_LAT = 1;
         ledTicks = currentTicks;
         if (ledTicks == 0) {
             ledTicks = 1; // value cannot be zero as this would indicate that the LED is not currently blinking
         }
     }
+#ifdef TWO_STEP_SYNCHRONISATION
+    if (followUpTicks != 0) {
+        if ((BroadcastSynchronisationFollowUpMessage() == 0) || ((currentTicks - followUpTicks) >= FOLLOW_UP_TIMEOUT)) {
+            followUpTicks = 0;
+        }
+    }
+#endif
     if (ledTicks != 0) {
         if ((currentTicks - ledTicks) >= (TIMER_TICKS_PER_SECOND / 10)) { // turn LED off after 100 ms
             LED3_LAT = 0;
@@ -83,44 +204,311 @@ void SendDoTasks() {
         }
     }
 
-    // Unicast external clock edge timestamp
-    if (externalTriggerTimestamp.value != 0) {
+    // Prepare next synchronisation message
+    if ((isSynchronisationPrepared == false) && (isSynchronisationSent == false) && (followUpTicks == 0)) {
+        PrepareSynchronisationMessage();
+    }
+#ifdef CPU_USAGE_ENABLED
+    taskTicks += TimerGetTicks32() - currentTicks;
+    BroadcastCpuUsage();
+#endif
 
-        UnicastExternalClockTimestamp();
+    // Send external clock edge timestamp to subscribers or UNICAST_IP
+    if ((externalClockBundleSize == 0) && (externalTriggerTimestamp.value != 0)) {
+        SendExternalClockTimestamp();
         externalTriggerTimestamp.value = 0;
     }
+    if (externalClockBundleSize != 0) {
+        ResumeExternalClockTimestamp();
+    }
+}
+
+/**
+ * @brief Sets the steady-state rate at which synchronisation messages are
+ * sent.  The rate is applied by the next call to SendDoTasks.  This function
+ * may be called from an interrupt.
+ * @param rate Rate (messages per second).
+ * @return 0 if successful.
+ */
+int SendSetSynchronisationRate(const int rate) {
+    if ((rate < 1) || (rate > MAX_SYNCHRONISATION_RATE)) {
+        return 1; // error: invalid rate
+    }
+    steadyPeriod = SYNCHRONISATION_PERIOD(rate);
+    return 0;
+}
+
+/**
+ * @brief Starts a burst of synchronisation messages at
+ * BURST_SYNCHRONISATION_RATE.  The burst is started by the next call to
+ * SendDoTasks.  This function may be called from an interrupt.
+ */
+void SendStartSynchronisationBurst() {
+    isBurstRequested = true;
 }
 
 /**
- * @brief Broadcasts synchronisation message.
+ * @brief Updates the period of synchronisation messages.
+ *
+ * A burst is started each time the link comes up or a burst is requested.  The
+ * burst period is maintained for BURST_DURATION and then doubled each second
+ * until it is no longer shorter than the steady-state period.  The timer is
+ * only restarted when the period changes.
  */
-static void BroadcastSynchronisationMessage() {
-    OscMessage oscMessage;
-    OscMessageInitialise(&oscMessage, "/sync");
-    OscMessageAddTimeTag(&oscMessage, SynchronisationTicksToOscTimeTag(TimerGetTicks64()));
-    OscPacket oscPacket;
-    OscPacketInitialiseFromContents(&oscPacket, &oscMessage);
-    EthernetBroadcast(oscPacket.contents, oscPacket.size);
+static void UpdateSynchronisationPeriod() {
+    const Ticks32 currentTicks = TimerGetTicks32();
+
+    // Start burst
+    static bool wasLinked = false;
+    const bool isLinked = EthernetIsLinked();
+    if (((isLinked == true) && (wasLinked == false)) || (isBurstRequested == true)) {
+        isBurstRequested = false;
+        burstPeriod = SYNCHRONISATION_PERIOD(BURST_SYNCHRONISATION_RATE);
+        burstStepTicks = currentTicks + (TIMER_TICKS_PER_SECOND * BURST_DURATION);
+    }
+    wasLinked = isLinked;
+
+    // Decay burst
+    if ((burstPeriod != 0) && ((int32_t) (currentTicks - burstStepTicks) >= 0)) {
+        burstPeriod *= 2;
+        burstStepTicks += TIMER_TICKS_PER_SECOND;
+    }
+    const Ticks32 steadyPeriodCopy = steadyPeriod;
+    if (burstPeriod >= steadyPeriodCopy) {
+        burstPeriod = 0; // burst complete
+    }
+
+    // Restart timer if period changed
+    const Ticks32 period = burstPeriod == 0 ? steadyPeriodCopy : burstPeriod;
+    if (period != synchronisationPeriod) {
+        StartSynchronisationTimer(period);
+    }
 }
 
 /**
- * @brief Unicasts external clock edge timestamp.
+ * @brief Starts the Timer2/3 period interrupt used to send synchronisation
+ * messages.
+ *
+ * Timer2/3 and the Timer module timebase are driven by the same clock.  The
+ * Timer2/3 value is set to the timebase value modulo the period so that each
+ * interrupt occurs, within a few ticks, when the timebase is a multiple of the
+ * period.  Synchronisation messages are therefore phase-locked to the timebase
+ * and lateness does not accumulate.  A prepared message remains prepared if
+ * the timer is restarted with a different period.
+ *
+ * @param period Period (timer ticks).
  */
-static void UnicastExternalClockTimestamp() {
-    OscBundle oscBundle;
-    OscBundleInitialise(&oscBundle, SynchronisationTicksToOscTimeTag(externalTriggerTimestamp));
-    OscMessage oscMessage;
-    OscMessageInitialise(&oscMessage, "/external");
-    OscMessageAddBool(&oscMessage, externalTriggerState);
-    OscBundleAddContents(&oscBundle, &oscMessage);
-    OscPacket oscPacket;
-    OscPacketInitialiseFromContents(&oscPacket, &oscBundle);
-    EthernetUnicast(oscPacket.contents, oscPacket.size);
+static void StartSynchronisationTimer(const Ticks32 period) {
+    T2CON = 0;
+    T3CON = 0;
+    T2CONbits.T32 = 1; // 32-bit timer with 1:1 prescaler
+    PR2 = period - 1;
+    const Ticks64 ticks64 = TimerGetTicks64();
+    uint32_t phase = (uint32_t) (ticks64.value % period);
+    phase += TimerGetTicks32() - ticks64.ticks32; // account for duration of modulo operation
+    if (phase >= period) {
+        phase -= period;
+    }
+    TMR2 = phase;
+    T2CONbits.ON = 1; // start timer
+    IPC3bits.T3IP = 4; // set interrupt priority
+    T3_IFSXCLR = T3_INT_BIT; // clear interrupt flag
+    T3_IECXSET = T3_INT_BIT; // enable interrupt
+    synchronisationPeriod = period;
+}
+
+/**
+ * @brief Prepares the next synchronisation message to be sent by the
+ * interrupt.
+ *
+ * The synchronisation message is an OSC message with the address "/sync" and
+ * the arguments:
+ * - time tag: master time when the message was sent
+ * - int32: sequence number, incremented for each message so that slaves may
+ *   detect lost and reordered messages
+ * - int32: frequency adjustment of the master clock relative to its timer as
+ *   a fraction of 2^32
+ * - int32: master uptime in seconds so that slaves may detect a restart
+ * - bool: true if the master clock was stepped since the previous message
+ *
+ * This firmware is a free-running master.  SynchronisationUpdate is never
+ * called and so the frequency adjustment is always 0 and the stepped flag is
+ * always false.  The fields are retained so that the message format is the
+ * same for a master that is itself disciplined, and slaves must not treat the
+ * fixed values as a measurement of the master's crystal.
+ *
+ * The OSC message template is copied directly into the UDP transmit buffer and
+ * the complete frame is built in advance so that the interrupt only needs to
+ * write the time tag and stepped flag.  The time between obtaining the time
+ * tag and the frame being handed to the MAC is therefore independent of the
+ * main program loop.
+ */
+static void PrepareSynchronisationMessage() {
+    OscMessageTemplateSetInt32(&synchronisationMessage, 1, sequenceNumber + 1);
+    OscMessageTemplateSetInt32(&synchronisationMessage, 2, SynchronisationGetFrequencyAdjustment());
+    OscMessageTemplateSetInt32(&synchronisationMessage, 3, (int32_t) (TimerGetTicks64().value / TIMER_TICKS_PER_SECOND));
+    char* destination;
+    size_t destinationSize;
+    if (EthernetGetBroadcastBuffer(&destination, &destinationSize) != 0) {
+        return; // error: transmit buffer not available
+    }
+    if (synchronisationMessage.size > destinationSize) {
+        return; // error: transmit buffer too small
+    }
+    memcpy(destination, synchronisationMessage.contents, synchronisationMessage.size);
+    if (EthernetPrepareBuffer(synchronisationMessage.size) != 0) {
+        return; // error: unable to prepare message
+    }
+    sequenceNumber++;
+    isSynchronisationPrepared = true;
+}
+
+#ifdef TWO_STEP_SYNCHRONISATION
+
+/**
+ * @brief Broadcasts synchronisation follow-up message containing the time
+ * that the synchronisation message was transmitted by the MAC.  The time is
+ * captured by the Ethernet TX done interrupt and so this function does not
+ * wait for the synchronisation message to be transmitted.
+ * @return 0 if successful.  An error is returned if the synchronisation
+ * message has not yet been transmitted.
+ */
+static int BroadcastSynchronisationFollowUpMessage() {
+    Ticks64 transmitTime;
+    if (EthernetGetTransmitTime(&transmitTime) != 0) {
+        return 1; // error: message not yet transmitted
+    }
+    OscMessageTemplateSetTimeTag(&synchronisationFollowUpMessage, 0, SynchronisationTicksToOscTimeTag(transmitTime));
+    OscMessageTemplateSetInt32(&synchronisationFollowUpMessage, 1, sequenceNumber);
+    return BroadcastMessageTemplate(&synchronisationFollowUpMessage);
+}
+
+#endif
+
+#ifdef CPU_USAGE_ENABLED
+
+/**
+ * @brief Broadcasts the current synchronisation rate and the percentage of CPU
+ * time used to send synchronisation messages.  This includes Timer3Interrupt
+ * and SendDoTasks but excludes the interrupt context save and restore.
+ */
+static void BroadcastCpuUsage() {
+    static Ticks32 previousTicks;
+    static Ticks32 previousInterruptTicks;
+    const Ticks32 currentTicks = TimerGetTicks32();
+    if ((currentTicks - previousTicks) < (TIMER_TICKS_PER_SECOND * CPU_USAGE_PERIOD)) {
+        return;
+    }
+    const Ticks32 interruptTicksCopy = interruptTicks;
+    const Ticks32 busyTicks = (interruptTicksCopy - previousInterruptTicks) + taskTicks;
+    const float cpuUsage = (100.0f * (float) busyTicks) / (float) (currentTicks - previousTicks);
+    previousTicks = currentTicks;
+    previousInterruptTicks = interruptTicksCopy;
+    taskTicks = 0;
+    OscMessageTemplateSetInt32(&cpuUsageMessage, 0, TIMER_TICKS_PER_SECOND / synchronisationPeriod);
+    OscMessageTemplateSetFloat32(&cpuUsageMessage, 1, cpuUsage);
+    BroadcastMessageTemplate(&cpuUsageMessage);
+}
+
+#endif
+
+/**
+ * @brief Broadcasts OSC message template.  The OSC message template is copied
+ * directly into the UDP transmit buffer.
+ * @param oscMessageTemplate Address of OSC message template.
+ * @return 0 if successful.
+ */
+static int BroadcastMessageTemplate(const OscMessageTemplate * const oscMessageTemplate) {
+    char* destination;
+    size_t destinationSize;
+    if (EthernetGetBroadcastBuffer(&destination, &destinationSize) != 0) {
+        return 1; // error: transmit buffer not available
+    }
+    if (oscMessageTemplate->size > destinationSize) {
+        return 1; // error: transmit buffer too small
+    }
+    memcpy(destination, oscMessageTemplate->contents, oscMessageTemplate->size);
+    return EthernetSendBuffer(oscMessageTemplate->size);
+}
+
+/**
+ * @brief Sends external clock edge timestamp to each subscriber.
+ *
+ * The OSC bundle is encoded once and the same bytes are sent to every
+ * subscriber by ResumeExternalClockTimestamp.  The OSC bundle is unicast to
+ * UNICAST_IP if there are no subscribers so that a host that does not
+ * subscribe continues to receive external clock edge timestamps.
+ */
+static void SendExternalClockTimestamp() {
+    OscBundleWriter oscBundleWriter;
+    if (OscBundleWriterInitialise(&oscBundleWriter, externalClockBundle, sizeof (externalClockBundle), SynchronisationTicksToOscTimeTag(externalTriggerTimestamp)) != 0) {
+        return; // error: destination too small
+    }
+    OscMessageWriter oscMessageWriter;
+    if (OscBundleWriterOpenMessage(&oscBundleWriter, &oscMessageWriter, "/external", externalTriggerState ? ",T" : ",F") != 0) {
+        return; // error: destination too small
+    }
+    OscBundleWriterCloseMessage(&oscBundleWriter, &oscMessageWriter);
+    size_t oscBundleSize;
+    if (OscBundleWriterFinalise(&oscBundleWriter, &oscBundleSize) != 0) {
+        return; // error: incomplete bundle
+    }
+    if (SubscribersGetNumberOfSubscribers() == 0) {
+        EthernetUnicast(externalClockBundle, oscBundleSize);
+        return;
+    }
+    externalClockBundleSize = oscBundleSize;
+    externalClockSubscriberIndex = 0;
+}
+
+/**
+ * @brief Sends the external clock edge timestamp OSC bundle to the remaining
+ * subscribers.
+ *
+ * Sending stops at the first subscriber for which a transmit buffer is not
+ * available and is resumed by the next call to SendDoTasks so that the main
+ * program loop never waits for the MAC.  A new external clock edge timestamp
+ * is not sent until the previous one has been sent to all subscribers.  The
+ * OSC bundle is abandoned if the link is down.
+ */
+static void ResumeExternalClockTimestamp() {
+    if ((SubscribersSend(externalClockBundle, externalClockBundleSize, &externalClockSubscriberIndex) == 0) || (EthernetIsLinked() == false)) {
+        externalClockBundleSize = 0;
+    }
 }
 
 //------------------------------------------------------------------------------
 // Functions - Interrupt
 
+/**
+ * Timer2/3 period interrupt to send the prepared synchronisation message.  The
+ * message is not sent if it has not been prepared in time, in which case the
+ * next message is sent at the next period.  The OSC type tag string and time
+ * tag are contiguous and so are replaced together to set the stepped flag.  In
+ * two-step mode, the transmit time is captured by the Ethernet TX done
+ * interrupt and the follow-up message is sent by the main program loop so that
+ * this interrupt never waits for the message to be transmitted.
+ */
+void __attribute__((interrupt(), vector(_TIMER_3_VECTOR))) Timer3Interrupt() {
+#ifdef CPU_USAGE_ENABLED
+    const Ticks32 startTicks = TimerGetTicks32();
+#endif
+    if (isSynchronisationPrepared == true) {
+        const uint32_t numberOfSteps = SynchronisationGetNumberOfSteps();
+        OscMessageTemplateSetTimeTag(&synchronisationMessage, 0, SynchronisationTicksToOscTimeTag(TimerGetTicks64()));
+        OscMessageTemplateSetBool(&synchronisationMessage, 4, numberOfSteps != sentNumberOfSteps);
+        sentNumberOfSteps = numberOfSteps;
+        const size_t index = synchronisationMessage.oscTypeTagStringIndex;
+        EthernetBroadcastPrepared(index, &synchronisationMessage.contents[index], (synchronisationMessage.argumentIndexes[0] + sizeof (OscTimeTag)) - index);
+        isSynchronisationPrepared = false;
+        isSynchronisationSent = true;
+    }
+#ifdef CPU_USAGE_ENABLED
+    interruptTicks += TimerGetTicks32() - startTicks;
+#endif
+    T3_IFSXCLR = T3_INT_BIT; // clear interrupt flag
+}
+
 /**
  * Input change notification interrupt service routine to store timestamp and
  * state of external trigger signal.
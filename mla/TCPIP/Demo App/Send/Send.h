@@ -12,6 +12,8 @@
 
 void SendInitialise();
 void SendDoTasks();
+int SendSetSynchronisationRate(const int rate);
+void SendStartSynchronisationBurst();
 
 #endif
 
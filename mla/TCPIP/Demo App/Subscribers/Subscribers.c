@@ -0,0 +1,176 @@
+/**
+ * @file Subscribers.c
+ * @author Seb Madgwick
+ * @brief Table of remote endpoints subscribed to receive unicast messages.
+ *
+ * Each subscription is held for a lease after which it expires unless
+ * renewed.  Endpoints are stored contiguously so that a message may be sent to
+ * all subscribers by EthernetUnicastToEach.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Subscribers.h"
+#include <string.h> // memcmp
+#include "Timer/Timer.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Maximum number of subscribers.  Each subscriber requires 20 bytes of
+ * RAM.  This value may be modified as required by the user application.
+ */
+#define MAX_NUMBER_OF_SUBSCRIBERS 64
+
+/**
+ * @brief Maximum lease (in seconds).  Longer leases are limited to this value
+ * so that a subscriber that does not unsubscribe is eventually removed.
+ */
+#define MAX_LEASE 3600
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static int FindSubscriber(const EthernetEndpoint * const endpoint);
+static void RemoveSubscriber(const size_t index);
+static void RemoveExpiredSubscribers();
+
+//------------------------------------------------------------------------------
+// Variables
+
+static EthernetEndpoint endpoints[MAX_NUMBER_OF_SUBSCRIBERS];
+static uint64_t expiries[MAX_NUMBER_OF_SUBSCRIBERS];
+static size_t numberOfSubscribers;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Adds a subscriber or renews the lease of an existing subscriber.
+ * Subscribers are identified by IP address and port.
+ * @param endpoint Address of endpoint.
+ * @param lease Lease in seconds.  The subscriber is removed if the lease is 0
+ * or less.
+ * @return 0 if successful.
+ */
+int SubscribersAdd(const EthernetEndpoint * const endpoint, const int32_t lease) {
+    const int existingIndex = FindSubscriber(endpoint);
+    if (lease <= 0) {
+        if (existingIndex >= 0) {
+            RemoveSubscriber(existingIndex);
+        }
+        return 0;
+    }
+    size_t index;
+    if (existingIndex >= 0) {
+        index = existingIndex;
+    } else {
+        RemoveExpiredSubscribers();
+        if (numberOfSubscribers >= MAX_NUMBER_OF_SUBSCRIBERS) {
+            return 1; // error: table full
+        }
+        index = numberOfSubscribers++;
+    }
+    endpoints[index] = *endpoint; // MAC address may have changed
+    const uint32_t leaseSeconds = lease > MAX_LEASE ? MAX_LEASE : lease;
+    expiries[index] = TimerGetTicks64().value + ((uint64_t) leaseSeconds * TIMER_TICKS_PER_SECOND);
+    return 0;
+}
+
+/**
+ * @brief Removes a subscriber.  Subscribers are identified by IP address and
+ * port.
+ * @param endpoint Address of endpoint.
+ */
+void SubscribersRemove(const EthernetEndpoint * const endpoint) {
+    const int index = FindSubscriber(endpoint);
+    if (index >= 0) {
+        RemoveSubscriber(index);
+    }
+}
+
+/**
+ * @brief Returns the number of subscribers.  Subscribers with an expired lease
+ * are removed first.
+ * @return Number of subscribers.
+ */
+size_t SubscribersGetNumberOfSubscribers() {
+    RemoveExpiredSubscribers();
+    return numberOfSubscribers;
+}
+
+/**
+ * @brief Sends a UDP packet to each subscriber starting from a subscriber
+ * index.  Sending stops at the first subscriber for which a transmit buffer is
+ * not available and the subscriber index is updated so that this function may
+ * be called again later to resume.  Subscribers with an expired lease are
+ * removed first if the subscriber index is 0.
+ *
+ * A subscriber may be skipped or sent the packet twice if the table changes
+ * before sending is resumed.
+ *
+ * @param source Address of packet.
+ * @param numberOfBytes Size of packet.
+ * @param subscriberIndex Address of the index of the next subscriber.  This
+ * should be 0 to start sending.
+ * @return 0 if the packet has been sent to all subscribers.
+ */
+int SubscribersSend(const char* const source, const size_t numberOfBytes, size_t * const subscriberIndex) {
+    if (*subscriberIndex == 0) {
+        RemoveExpiredSubscribers();
+    }
+    if (*subscriberIndex >= numberOfSubscribers) {
+        return 0;
+    }
+    size_t numberOfSubscribersSent;
+    const int result = EthernetUnicastToEach(&endpoints[*subscriberIndex], numberOfSubscribers - *subscriberIndex, source, numberOfBytes, &numberOfSubscribersSent);
+    *subscriberIndex += numberOfSubscribersSent;
+    return result;
+}
+
+/**
+ * @brief Returns the index of a subscriber with the same IP address and port
+ * as the endpoint.
+ * @param endpoint Address of endpoint.
+ * @return Index of subscriber.  -1 if not found.
+ */
+static int FindSubscriber(const EthernetEndpoint * const endpoint) {
+    size_t index;
+    for (index = 0; index < numberOfSubscribers; index++) {
+        if ((endpoints[index].port == endpoint->port) && (memcmp(endpoints[index].ipAddress, endpoint->ipAddress, sizeof (endpoint->ipAddress)) == 0)) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Removes a subscriber by moving the last subscriber into its place so
+ * that the table remains contiguous.
+ * @param index Index of subscriber.
+ */
+static void RemoveSubscriber(const size_t index) {
+    numberOfSubscribers--;
+    endpoints[index] = endpoints[numberOfSubscribers];
+    expiries[index] = expiries[numberOfSubscribers];
+}
+
+/**
+ * @brief Removes subscribers with an expired lease.
+ */
+static void RemoveExpiredSubscribers() {
+    const uint64_t currentTicks = TimerGetTicks64().value;
+    size_t index = 0;
+    while (index < numberOfSubscribers) {
+        if (currentTicks >= expiries[index]) {
+            RemoveSubscriber(index); // last subscriber moved to index
+        } else {
+            index++;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,38 @@
+/**
+ * @file Subscribers.h
+ * @author Seb Madgwick
+ * @brief Table of remote endpoints subscribed to receive unicast messages.
+ */
+
+#ifndef SUBSCRIBERS_H
+#define SUBSCRIBERS_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Ethernet/Ethernet.h"
+#include <stddef.h> // size_t
+#include <stdint.h> // int32_t
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Lease (in seconds) used if a subscriber does not specify one.  A
+ * subscriber must renew its subscription before the lease expires.  This value
+ * may be modified as required by the user application.
+ */
+#define SUBSCRIBERS_DEFAULT_LEASE 60
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+int SubscribersAdd(const EthernetEndpoint * const endpoint, const int32_t lease);
+void SubscribersRemove(const EthernetEndpoint * const endpoint);
+size_t SubscribersGetNumberOfSubscribers();
+int SubscribersSend(const char* const source, const size_t numberOfBytes, size_t * const subscriberIndex);
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
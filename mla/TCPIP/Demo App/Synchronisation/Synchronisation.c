@@ -3,13 +3,18 @@
  * @author Seb Madgwick
  * @brief Provides a measurement of time synchronised with a remote
  * synchronisation master.
+ *
+ * This firmware is the synchronisation master and so SynchronisationUpdate is
+ * never called.  The slave clock remains equal to the timer and the servo is
+ * only used when this module is built into a slave.  The servo is simulated on
+ * the host by Tests/SynchronisationServoTest.c.
  */
 
 //------------------------------------------------------------------------------
 // Includes
 
-#include <ieee754.h>
-#include <stdint.h> // UINT32_MAX
+#include <stdbool.h> // bool
+#include <stdint.h> // int32_t, int64_t, uint32_t, uint64_t
 #include "Synchronisation.h"
 
 //------------------------------------------------------------------------------
@@ -17,8 +22,8 @@
 
 /**
  * @brief Threshold (in timer ticks) used to determine if the slave clock
- * should jump directly to the master clock.  This value may be adjusted as
- * required by the user application.
+ * should step directly to the master clock rather than slew.  This value may be
+ * adjusted as required by the user application.
  *
  * The threshold value should be greater than the expected maximum communication
  * latency between the master and client.  The units are timer ticks.  For
@@ -28,25 +33,121 @@
 #define THRESHOLD (TIMER_TICKS_PER_SECOND / 2)
 
 /**
- * @brief Drift rate of the slow clock (in timer ticks).  This value may be
+ * @brief Time constant (in timer ticks) of the clock servo.  This value may be
  * adjusted as required by the user application.
  *
- * Must be greater than the expected worse-case relative difference in speed
- * between the master and slave clocks.  For example, if both the master and
- * slave derive clocks are derived from a ±10 ppm crystal then SLOW_CLOCK_DRIFT
- * should be at least 20 us per second.  The units are timer ticks.  For
- * example, a rate of 20 us per second would be specified as a SLOW_CLOCK_DRIFT
- * value of (TIMER_TICKS_PER_SECOND / (1000000ul / 20)).
+ * The gains are defined per unit time rather than per update so that the
+ * response of the servo is independent of the synchronisation rate.  Each
+ * update removes interval / TIME_CONSTANT of the measured offset, limited to
+ * one half, and adjusts the frequency by the offset multiplied by
+ * interval / (4 * TIME_CONSTANT^2) so that the servo is critically damped.  A
+ * longer time constant averages the network jitter of more updates but
+ * corrects a change in frequency more slowly.
+ */
+#define TIME_CONSTANT (3 * (uint64_t) TIMER_TICKS_PER_SECOND)
+
+/**
+ * @brief Maximum frequency adjustment of the slave clock as a fraction of
+ * 2^32.  Must be greater than the expected worst-case relative difference in
+ * speed between the master and slave clocks.  For example, if both clocks are
+ * derived from a ±50 ppm crystal then the maximum should be at least 100 ppm.
+ */
+#define MAX_FREQUENCY_ADJUSTMENT ((int32_t) (0x100000000ull / (1000000ul / 500))) // 500 ppm
+
+/**
+ * @brief Maximum interval (in timer ticks) between updates for which the
+ * frequency may be estimated.  The slave clock is stepped if this is exceeded.
+ * Approximately 3.8 hours.
  */
-#define SLOW_CLOCK_DRIFT 0
+#define MAX_UPDATE_INTERVAL (1ull << 40)
+
+/**
+ * @brief Uncomment this definition to disable the minimum delay filter so that
+ * every update is used by the servo.  The host simulation also builds the
+ * module with the filter disabled to measure the effect of the filter.
+ */
+//#define FILTER_DISABLED
+
+/**
+ * @brief Number of periods retained to determine the network delay.  This
+ * value may be adjusted as required by the user application.
+ */
+#define FILTER_WINDOW_SIZE 8
+
+/**
+ * @brief Period (in timer ticks) for which the least delayed update is
+ * retained in each window entry.  The window therefore spans at least
+ * FILTER_WINDOW_SIZE updates and approximately one TIME_CONSTANT at high
+ * synchronisation rates.
+ */
+#define FILTER_PERIOD (TIME_CONSTANT / FILTER_WINDOW_SIZE)
+
+/**
+ * @brief Update received from the master.
+ */
+typedef struct {
+    uint64_t observedMasterClock;
+    uint64_t timeOfArrival;
+} Sample;
+
+/**
+ * @brief Slave clock model.  The slave clock is clock at timer ticks value
+ * ticks and advances at (1 + frequencyAdjustment / 2^32) times the rate of the
+ * timer.  An additional slewAdjustment is applied for slewDuration timer ticks
+ * to slew out the offset measured by the servo.
+ */
+typedef struct {
+    uint64_t ticks;
+    uint64_t clock;
+    int32_t frequencyAdjustment;
+    int32_t slewAdjustment;
+    uint64_t slewDuration;
+} ClockModel;
+
+/**
+ * @brief Clock servo states.
+ */
+typedef enum {
+    ServoStateUnlocked, // no previous update
+    ServoStateFrequencyEstimate, // one previous update
+    ServoStateLocked,
+} ServoState;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static bool FilterUpdate(uint64_t * const observedMasterClock, const uint64_t timeOfArrival);
+static void UpdateServo(const uint64_t observedMasterClock, const uint64_t timeOfArrival);
+static uint64_t TicksToSlaveClock(const ClockModel * const model, const uint64_t ticks);
+static uint64_t SlaveClockToTicks(const ClockModel * const model, const uint64_t clock);
+static int64_t DivideByFrequencyAdjustment(const int64_t value, const int32_t frequencyAdjustment);
+static int64_t MultiplyFrequencyAdjustment(const int64_t value, const int32_t frequencyAdjustment);
+static int64_t GetFractionalError(const int64_t error, const uint64_t interval);
+static int64_t Clamp(const int64_t value, const int64_t limit);
+static uint64_t TicksToOscTimeTag(const uint64_t ticks);
+static uint64_t OscTimeTagToTicks(const uint64_t oscTimeTag);
+static uint64_t DivideByTicksPerSecond(const uint64_t dividend);
+static uint64_t MultiplyHigh(const uint64_t a, const uint64_t b);
 
 //------------------------------------------------------------------------------
 // Variable declarations
 
-static ieee754dp ticksToOscTimeTag; // constant ratio
-static ieee754dp oscTimeTagToTicks; // constant ratio
-static uint64_t slaveClockOffset; // offset added to timer ticks to yield the slave clock
+static uint32_t ticksPerSecond; // constant divisor
+static uint64_t ticksPerSecondReciprocal; // floor(2^(64 + reciprocalShift) / ticksPerSecond)
+static int reciprocalShift; // floor(log2(ticksPerSecond))
+static ClockModel clockModels[2]; // active model and model being updated
+static const ClockModel* volatile clockModel; // active model, may be read from an interrupt
+static Sample samples[FILTER_WINDOW_SIZE];
+static int numberOfSamples;
+static int sampleIndex; // index of next sample, the oldest once window is full
+static uint64_t periodStart; // time of arrival of first update in period of newest sample
+static uint64_t previousSelectedTimeOfArrival; // time of arrival of sample previously used by servo
+static ServoState servoState;
+static uint64_t previousServoTimeOfArrival; // time of arrival of previous update used by servo
+static uint64_t previousObservedMasterClock;
+static int64_t frequencyIntegral; // integral term as fraction of 2^32
 static uint64_t observedMasterClockOffset; // offset added to timer ticks to yield the observed master clock
+static volatile uint32_t numberOfSteps; // number of times the slave clock has been stepped
 
 //------------------------------------------------------------------------------
 // Functions
@@ -54,54 +155,405 @@ static uint64_t observedMasterClockOffset; // offset added to timer ticks to yie
 /**
  * @brief Initialises module.  This function should be called once on system
  * start up.
+ *
+ * The reciprocal of the number of ticks per second is calculated here by long
+ * division so that the conversion functions only require integer multiplies.
+ * The shift is chosen so that the reciprocal uses all 64 bits without
+ * overflowing.
  */
 void SynchronisationInitialise() {
-    ticksToOscTimeTag = ieee754dp_div(ieee754dp_fulong(UINT32_MAX), ieee754dp_fulong(TIMER_TICKS_PER_SECOND + SLOW_CLOCK_DRIFT));
-    oscTimeTagToTicks = ieee754dp_div(ieee754dp_fulong(TIMER_TICKS_PER_SECOND + SLOW_CLOCK_DRIFT), ieee754dp_fulong(UINT32_MAX));
+    ticksPerSecond = TIMER_TICKS_PER_SECOND;
+    reciprocalShift = 0;
+    while ((ticksPerSecond >> (reciprocalShift + 1)) != 0) {
+        reciprocalShift++;
+    }
+    uint64_t remainder = 1;
+    ticksPerSecondReciprocal = 0;
+    int bitIndex;
+    for (bitIndex = 0; bitIndex < (64 + reciprocalShift); bitIndex++) {
+        remainder <<= 1;
+        ticksPerSecondReciprocal <<= 1;
+        if (remainder >= ticksPerSecond) {
+            remainder -= ticksPerSecond;
+            ticksPerSecondReciprocal |= 1;
+        }
+    }
+    clockModels[0].ticks = 0;
+    clockModels[0].clock = 0;
+    clockModels[0].frequencyAdjustment = 0;
+    clockModels[0].slewAdjustment = 0;
+    clockModels[0].slewDuration = 0;
+    clockModel = &clockModels[0];
+    numberOfSamples = 0;
+    sampleIndex = 0;
+    previousSelectedTimeOfArrival = 0;
+    servoState = ServoStateUnlocked;
+    frequencyIntegral = 0;
 }
 
 /**
  * @brief Updates synchronisation algorithm with time received from master.
  * This function should be called each time a synchronisation message is
- * received from the master.
+ * received from the master.  It is not called by this firmware because the
+ * firmware is the master.
+ *
+ * Updates are passed through a minimum delay filter once the slave clock is
+ * locked so that the servo is disciplined only by the least delayed updates.
+ *
  * @param oscTimeTag OSC time tag received from master.
  * @param timeOfArrival Timer ticks value when the OSC time tag was received
  * from the master.
  */
 void SynchronisationUpdate(const OscTimeTag oscTimeTag, const Ticks64 timeOfArrival) {
-    const uint64_t observedMasterClock = ieee754dp_tulong(ieee754dp_mul(ieee754dp_fulong(oscTimeTag.value), oscTimeTagToTicks)); // convert OSC time tag to ticks
-    const uint64_t slowClock = timeOfArrival.value + slaveClockOffset;
+    const uint64_t observedMasterClock = OscTimeTagToTicks(oscTimeTag.value);
     observedMasterClockOffset = observedMasterClock - timeOfArrival.value;
-    if (observedMasterClock < slowClock) {
-        if ((slowClock - observedMasterClock) < THRESHOLD) {
-            return; // ignore update if behind slave time and within threshold
+    uint64_t filteredMasterClock = observedMasterClock;
+#ifndef FILTER_DISABLED
+    if ((servoState == ServoStateLocked) && (FilterUpdate(&filteredMasterClock, timeOfArrival.value) == false)) {
+        return;
+    }
+#endif
+    UpdateServo(filteredMasterClock, timeOfArrival.value);
+}
+
+/**
+ * @brief Adds the sample to the window and provides the least delayed sample
+ * within the window as the master clock at the time of arrival.
+ *
+ * Each window entry holds the least delayed sample received within a
+ * FILTER_PERIOD.  Each sample is compared to the slave clock without the slew
+ * so that the comparison is independent of the age of the sample.  Network
+ * delay appears as a negative error and so the least delayed sample has the
+ * largest error.  The error of the least delayed sample is added to the slave
+ * clock without the slew at the time of arrival so that the servo is
+ * disciplined as if the sample had just been received.
+ *
+ * Each sample is used by the servo once.  The servo averages updates over
+ * TIME_CONSTANT and so repeatedly using the same sample would only weight the
+ * average towards that sample.  Outliers are not rejected separately because a
+ * delayed sample is never the least delayed.
+ *
+ * @param observedMasterClock Address of the master clock received from the
+ * master.  Overwritten with the filtered master clock.
+ * @param timeOfArrival Timer ticks value when the master clock was received.
+ * @return true if the filtered master clock should be used by the servo.
+ */
+static bool FilterUpdate(uint64_t * const observedMasterClock, const uint64_t timeOfArrival) {
+    const ClockModel * const model = clockModel;
+
+    // Add sample to window
+    const int newestIndex = (sampleIndex + FILTER_WINDOW_SIZE - 1) % FILTER_WINDOW_SIZE;
+    if ((numberOfSamples > 0) && ((timeOfArrival - periodStart) < FILTER_PERIOD)) {
+        const int64_t elapsed = (int64_t) (timeOfArrival - samples[newestIndex].timeOfArrival);
+        if ((int64_t) (*observedMasterClock - (samples[newestIndex].observedMasterClock + elapsed + MultiplyFrequencyAdjustment(elapsed, model->frequencyAdjustment))) > 0) {
+            samples[newestIndex].observedMasterClock = *observedMasterClock; // replace if less delayed
+            samples[newestIndex].timeOfArrival = timeOfArrival;
         }
+    } else {
+        periodStart = timeOfArrival;
+        samples[sampleIndex].observedMasterClock = *observedMasterClock;
+        samples[sampleIndex].timeOfArrival = timeOfArrival;
+        sampleIndex = (sampleIndex + 1) % FILTER_WINDOW_SIZE;
+        if (numberOfSamples < FILTER_WINDOW_SIZE) {
+            numberOfSamples++;
+        }
+    }
+
+    // Select least delayed
+    int leastDelayedIndex = 0;
+    int64_t leastDelayedError = 0;
+    int index;
+    for (index = 0; index < numberOfSamples; index++) {
+        const int64_t elapsed = (int64_t) (samples[index].timeOfArrival - model->ticks);
+        const int64_t error = (int64_t) (samples[index].observedMasterClock - (model->clock + elapsed + MultiplyFrequencyAdjustment(elapsed, model->frequencyAdjustment)));
+        if ((index == 0) || (error > leastDelayedError)) {
+            leastDelayedIndex = index;
+            leastDelayedError = error;
+        }
+    }
+    if ((int64_t) (samples[leastDelayedIndex].timeOfArrival - previousSelectedTimeOfArrival) <= 0) {
+        return false; // sample already used
+    }
+    previousSelectedTimeOfArrival = samples[leastDelayedIndex].timeOfArrival;
+    const int64_t elapsed = (int64_t) (timeOfArrival - model->ticks);
+    *observedMasterClock = model->clock + elapsed + MultiplyFrequencyAdjustment(elapsed, model->frequencyAdjustment) + leastDelayedError;
+    return true;
+}
+
+/**
+ * @brief Updates the clock servo.
+ *
+ * The slave clock is disciplined by a PI servo.  The first update steps the
+ * slave clock to the master clock.  The first update at least TIME_CONSTANT
+ * later estimates the frequency difference from the two updates and steps the
+ * slave clock again.  The interval is not shorter so that the estimate is not
+ * dominated by network jitter.  Each subsequent update adjusts the frequency
+ * of the slave clock by the integral term and slews out the proportional term
+ * over the interval since the previous update used by the servo.  This is the
+ * interval expected before the next update used because the filter does not
+ * use every update.  The slave clock is stepped if the offset exceeds
+ * THRESHOLD.  The window of samples is cleared each time the slave clock is
+ * stepped.
+ *
+ * @param observedMasterClock Master clock received from the master.
+ * @param timeOfArrival Timer ticks value when the master clock was received.
+ */
+static void UpdateServo(const uint64_t observedMasterClock, const uint64_t timeOfArrival) {
+    const uint64_t interval = timeOfArrival - previousServoTimeOfArrival;
+    if ((servoState != ServoStateUnlocked) && (interval == 0)) {
+        return; // ignore update if no time has elapsed
+    }
+    if ((servoState == ServoStateFrequencyEstimate) && (interval < TIME_CONSTANT)) {
+        return; // ignore update until interval is long enough to estimate frequency
+    }
+
+    // Model is updated in inactive copy so that interrupts never see a partially updated model
+    const ClockModel * const model = clockModel;
+    ClockModel * const nextModel = (model == &clockModels[0]) ? &clockModels[1] : &clockModels[0];
+    nextModel->ticks = timeOfArrival;
+    nextModel->clock = observedMasterClock; // step unless slewing
+    nextModel->frequencyAdjustment = (int32_t) frequencyIntegral;
+    nextModel->slewAdjustment = 0;
+    nextModel->slewDuration = 0;
+    const int64_t error = (int64_t) (observedMasterClock - TicksToSlaveClock(model, timeOfArrival));
+    const uint64_t gainInterval = interval < (TIME_CONSTANT / 2) ? interval : (TIME_CONSTANT / 2);
+    const int64_t proportionalTerm = (Clamp(error, THRESHOLD) * (int64_t) gainInterval) / (int64_t) TIME_CONSTANT; // error limited so that product cannot overflow
+    bool isStep = true;
+    switch (servoState) {
+        case ServoStateUnlocked:
+            servoState = ServoStateFrequencyEstimate;
+            break;
+        case ServoStateFrequencyEstimate:
+            if (interval > MAX_UPDATE_INTERVAL) {
+                break; // step and estimate frequency from next update
+            }
+            frequencyIntegral = GetFractionalError((int64_t) ((observedMasterClock - previousObservedMasterClock) - interval), interval);
+            nextModel->frequencyAdjustment = (int32_t) frequencyIntegral;
+            servoState = ServoStateLocked;
+            break;
+        case ServoStateLocked:
+            if ((interval > MAX_UPDATE_INTERVAL) || (error > (int64_t) THRESHOLD) || (error < -(int64_t) THRESHOLD)) {
+                break; // step
+            }
+            frequencyIntegral = Clamp(frequencyIntegral + GetFractionalError(proportionalTerm, 4 * TIME_CONSTANT), MAX_FREQUENCY_ADJUSTMENT);
+            nextModel->clock = TicksToSlaveClock(model, timeOfArrival); // slew
+            nextModel->frequencyAdjustment = (int32_t) frequencyIntegral;
+            nextModel->slewAdjustment = (int32_t) GetFractionalError(proportionalTerm, interval);
+            nextModel->slewDuration = interval;
+            isStep = false;
+            break;
+    }
+    if (isStep == true) {
+        numberOfSamples = 0;
+        sampleIndex = 0;
+        numberOfSteps++;
     }
-    slaveClockOffset = observedMasterClockOffset;
+    previousServoTimeOfArrival = timeOfArrival;
+    previousObservedMasterClock = observedMasterClock;
+    clockModel = nextModel;
+}
+
+/**
+ * @brief Returns the frequency adjustment of the slave clock relative to the
+ * timer as a fraction of 2^32.  This is the servo's estimate of the frequency
+ * difference between the master and the timer and excludes any slew in
+ * progress.  This function may be called from an interrupt.
+ * @return Frequency adjustment as a fraction of 2^32.
+ */
+int32_t SynchronisationGetFrequencyAdjustment() {
+    return clockModel->frequencyAdjustment;
+}
+
+/**
+ * @brief Returns the number of times the slave clock has been stepped.  A
+ * change in this value indicates that the clock is discontinuous between two
+ * calls.  This function may be called from an interrupt.
+ * @return Number of times the slave clock has been stepped.
+ */
+uint32_t SynchronisationGetNumberOfSteps() {
+    return numberOfSteps;
 }
 
 /**
  * @brief Converts timer ticks value to an OSC time tag time corresponding to
- * the slave clock synchronised with the master.
+ * the slave clock synchronised with the master.  This function may be called
+ * from an interrupt.
  * @param ticks64 Timer ticks value.
  * @return OSC time tag time corresponding to the slave clock synchronised with
  * the master.
  */
 OscTimeTag SynchronisationTicksToOscTimeTag(const Ticks64 ticks64) {
-    const OscTimeTag oscTimeTag = {.value = ieee754dp_tulong(ieee754dp_mul(ieee754dp_fulong(ticks64.value + slaveClockOffset), ticksToOscTimeTag))};
+    const OscTimeTag oscTimeTag = {.value = TicksToOscTimeTag(TicksToSlaveClock(clockModel, ticks64.value))};
     return oscTimeTag;
 }
 
 /**
  * @brief Converts timer ticks value to an OSC time tag time corresponding to
- * the observed master clock.
+ * the observed master clock.  This function may be called from an interrupt.
  * @param ticks64 Timer ticks value.
  * @return OSC time tag time corresponding to the observed master clock.
  */
 OscTimeTag SynchronisationTicksToOscTimeTagAsObserved(const Ticks64 ticks64) {
-    const OscTimeTag oscTimeTag = {.value = ieee754dp_tulong(ieee754dp_mul(ieee754dp_fulong(ticks64.value + observedMasterClockOffset), ticksToOscTimeTag))};
+    const OscTimeTag oscTimeTag = {.value = TicksToOscTimeTag(ticks64.value + observedMasterClockOffset)};
     return oscTimeTag;
 }
 
+/**
+ * @brief Converts an OSC time tag time corresponding to the slave clock
+ * synchronised with the master to a timer ticks value.  This is the inverse of
+ * SynchronisationTicksToOscTimeTag.  This function may be called from an
+ * interrupt.
+ * @param oscTimeTag OSC time tag time corresponding to the slave clock
+ * synchronised with the master.
+ * @return Timer ticks value.
+ */
+Ticks64 SynchronisationOscTimeTagToTicks(const OscTimeTag oscTimeTag) {
+    const Ticks64 ticks64 = {.value = SlaveClockToTicks(clockModel, OscTimeTagToTicks(oscTimeTag.value))};
+    return ticks64;
+}
+
+/**
+ * @brief Converts timer ticks to the slave clock.
+ * @param model Address of the slave clock model.
+ * @param ticks Timer ticks value.
+ * @return Slave clock in timer ticks.
+ */
+static uint64_t TicksToSlaveClock(const ClockModel * const model, const uint64_t ticks) {
+    const int64_t elapsed = (int64_t) (ticks - model->ticks);
+    const int64_t slewElapsed = elapsed > (int64_t) model->slewDuration ? (int64_t) model->slewDuration : elapsed;
+    return model->clock + elapsed + MultiplyFrequencyAdjustment(elapsed, model->frequencyAdjustment) + MultiplyFrequencyAdjustment(slewElapsed, model->slewAdjustment);
+}
+
+/**
+ * @brief Converts the slave clock to timer ticks.  This is the inverse of
+ * TicksToSlaveClock.
+ * @param model Address of the slave clock model.
+ * @param clock Slave clock in timer ticks.
+ * @return Timer ticks value.
+ */
+static uint64_t SlaveClockToTicks(const ClockModel * const model, const uint64_t clock) {
+    const uint64_t slewEndTicks = model->ticks + model->slewDuration;
+    const uint64_t slewEndClock = TicksToSlaveClock(model, slewEndTicks);
+    if ((int64_t) (clock - slewEndClock) > 0) {
+        return slewEndTicks + DivideByFrequencyAdjustment((int64_t) (clock - slewEndClock), model->frequencyAdjustment);
+    }
+    return model->ticks + DivideByFrequencyAdjustment((int64_t) (clock - model->clock), model->frequencyAdjustment + model->slewAdjustment);
+}
+
+/**
+ * @brief Divides a value by (1 + frequencyAdjustment / 2^32).  The division is
+ * approximated by two fixed-point iterations, the error of which is less than
+ * one tick for values of up to several hours.
+ * @param value Value.
+ * @param frequencyAdjustment Frequency adjustment as fraction of 2^32.
+ * @return value / (1 + frequencyAdjustment / 2^32).
+ */
+static int64_t DivideByFrequencyAdjustment(const int64_t value, const int32_t frequencyAdjustment) {
+    const int64_t quotient = value - MultiplyFrequencyAdjustment(value, frequencyAdjustment);
+    return value - MultiplyFrequencyAdjustment(quotient, frequencyAdjustment);
+}
+
+/**
+ * @brief Multiplies a value by a frequency adjustment.  The full 128-bit
+ * product is used so that the result cannot overflow.
+ * @param value Value.
+ * @param frequencyAdjustment Frequency adjustment as fraction of 2^32.
+ * @return value * frequencyAdjustment / 2^32 rounded towards zero.
+ */
+static int64_t MultiplyFrequencyAdjustment(const int64_t value, const int32_t frequencyAdjustment) {
+    const bool isNegative = (value < 0) != (frequencyAdjustment < 0);
+    const uint64_t magnitude = MultiplyHigh(value < 0 ? -(uint64_t) value : (uint64_t) value, (uint64_t) (frequencyAdjustment < 0 ? -(int64_t) frequencyAdjustment : frequencyAdjustment) << 32);
+    return isNegative ? -(int64_t) magnitude : (int64_t) magnitude;
+}
+
+/**
+ * @brief Returns an error as a fraction of an interval limited to
+ * MAX_FREQUENCY_ADJUSTMENT.  The error is limited before scaling so that the
+ * calculation cannot overflow.
+ * @param error Error in timer ticks.
+ * @param interval Interval in timer ticks.  Must be greater than zero and not
+ * greater than MAX_UPDATE_INTERVAL.
+ * @return error * 2^32 / interval limited to MAX_FREQUENCY_ADJUSTMENT.
+ */
+static int64_t GetFractionalError(const int64_t error, const uint64_t interval) {
+    const int64_t limit = (int64_t) ((interval * MAX_FREQUENCY_ADJUSTMENT) >> 32) + 1;
+    return Clamp((Clamp(error, limit) * 0x100000000ll) / (int64_t) interval, MAX_FREQUENCY_ADJUSTMENT);
+}
+
+/**
+ * @brief Limits a value to the range -limit to limit.
+ * @param value Value.
+ * @param limit Limit.
+ * @return Limited value.
+ */
+static int64_t Clamp(const int64_t value, const int64_t limit) {
+    if (value > limit) {
+        return limit;
+    }
+    if (value < -limit) {
+        return -limit;
+    }
+    return value;
+}
+
+/**
+ * @brief Converts ticks to an OSC time tag.  The result is exactly
+ * floor(ticks * 2^32 / ticksPerSecond) modulo 2^64.
+ * @param ticks Ticks.
+ * @return OSC time tag value.
+ */
+static uint64_t TicksToOscTimeTag(const uint64_t ticks) {
+    const uint64_t seconds = DivideByTicksPerSecond(ticks);
+    const uint64_t remainder = ticks - (seconds * ticksPerSecond); // less than 2^32 so remainder << 32 cannot overflow
+    return (seconds << 32) + DivideByTicksPerSecond(remainder << 32);
+}
+
+/**
+ * @brief Converts an OSC time tag to ticks.  The result is exactly
+ * floor(oscTimeTag * ticksPerSecond / 2^32) modulo 2^64.
+ * @param oscTimeTag OSC time tag value.
+ * @return Ticks.
+ */
+static uint64_t OscTimeTagToTicks(const uint64_t oscTimeTag) {
+    const uint64_t seconds = oscTimeTag >> 32;
+    const uint64_t fraction = oscTimeTag & 0xFFFFFFFF;
+    return (seconds * ticksPerSecond) + ((fraction * ticksPerSecond) >> 32); // fraction * ticksPerSecond cannot overflow
+}
+
+/**
+ * @brief Divides by ticksPerSecond using the precomputed reciprocal.  The
+ * multiply-high estimate is at most one less than the exact quotient so a
+ * single correction step yields the exact result.
+ * @param dividend Dividend.
+ * @return floor(dividend / ticksPerSecond).
+ */
+static uint64_t DivideByTicksPerSecond(const uint64_t dividend) {
+    uint64_t quotient = MultiplyHigh(dividend, ticksPerSecondReciprocal) >> reciprocalShift;
+    if ((dividend - (quotient * ticksPerSecond)) >= ticksPerSecond) {
+        quotient++;
+    }
+    return quotient;
+}
+
+/**
+ * @brief Returns the most-significant 64 bits of the 128-bit product of two
+ * 64-bit values.  Only 32 x 32 bit multiplies are used.
+ * @param a Multiplicand.
+ * @param b Multiplier.
+ * @return floor(a * b / 2^64).
+ */
+static uint64_t MultiplyHigh(const uint64_t a, const uint64_t b) {
+    const uint64_t aLow = (uint32_t) a;
+    const uint64_t aHigh = a >> 32;
+    const uint64_t bLow = (uint32_t) b;
+    const uint64_t bHigh = b >> 32;
+    const uint64_t lowLow = aLow * bLow;
+    const uint64_t lowHigh = aLow * bHigh;
+    const uint64_t highLow = aHigh * bLow;
+    const uint64_t highHigh = aHigh * bHigh;
+    const uint64_t middle = (lowLow >> 32) + (uint32_t) lowHigh + (uint32_t) highLow; // cannot overflow
+    return highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+}
+
 //------------------------------------------------------------------------------
 // End of file
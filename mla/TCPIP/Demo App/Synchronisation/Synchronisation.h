@@ -20,6 +20,9 @@ void SynchronisationInitialise();
 void SynchronisationUpdate(const OscTimeTag oscTimeTag, const Ticks64 timeOfReception);
 OscTimeTag SynchronisationTicksToOscTimeTag(const Ticks64 ticks64);
 OscTimeTag SynchronisationTicksToOscTimeTagAsObserved(const Ticks64 ticks64);
+Ticks64 SynchronisationOscTimeTagToTicks(const OscTimeTag oscTimeTag);
+int32_t SynchronisationGetFrequencyAdjustment();
+uint32_t SynchronisationGetNumberOfSteps();
 
 #endif
 
@@ -71,6 +71,7 @@
 //#define STACK_USE_SSL_CLIENT			// SSL client socket support (Requires SW300052)
 //#define STACK_USE_AUTO_IP               // Dynamic link-layer IP address automatic configuration protocol
 #define STACK_USE_DHCP_CLIENT			// Dynamic Host Configuration Protocol client for obtaining IP address and other parameters
+//#define STACK_USE_IGMP					// IGMPv2 multicast group membership, required to receive multicast.  Enable only with MULTICAST_IP in Ethernet.c as it changes the MAC multicast filter
 //#define STACK_USE_DHCP_SERVER			// Single host DHCP server
 //#define STACK_USE_FTP_SERVER			// File Transfer Protocol (old)
 //#define STACK_USE_SMTP_CLIENT			// Simple Mail Transfer Protocol for sending email
@@ -197,8 +198,13 @@
 	#define	ETH_CFG_AUTO_MDIX	1		// use/advertise auto MDIX capability
 	#define	ETH_CFG_SWAP_MDIX	1		// use swapped MDIX. else normal MDIX
 
-#define EMAC_TX_DESCRIPTORS		2		// number of the TX descriptors to be created
-#define EMAC_RX_DESCRIPTORS		8		// number of the RX descriptors and RX buffers to be created
+#define EMAC_TX_DESCRIPTORS		3		// number of the TX descriptors to be created
+#define EMAC_RX_DESCRIPTORS		24		// number of the RX descriptors and RX buffers to be created
+										// Increased from 8 so that a burst of /delay_req packets from many slaves,
+										// which arrive faster than the replies can be sent, is buffered rather than
+										// dropped by the ETHC.  Each packet occupies a whole RX buffer and so the
+										// additional 16 buffers use 24 KB of RAM.  This may be reduced if the RAM is
+										// required and there are few slaves.
 
 #define	EMAC_RX_BUFF_SIZE		1536	// size of a RX buffer. should be multiple of 16
 										// this is the size of all receive buffers processed by the ETHC
@@ -0,0 +1,28 @@
+/**
+ * @file BenchmarkMain.c
+ * @author Seb Madgwick
+ * @brief Host benchmark entry point.  Runs the Osc99 benchmarks of
+ * Benchmark.c natively and prints the results as JSON.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Benchmark/Benchmark.h"
+#include <stdio.h> // printf
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Benchmark entry point.
+ * @return 0 if no benchmark failed or exceeded its regression threshold.
+ */
+int main(void) {
+    const int result = BenchmarkRun();
+    printf("%s\n", BenchmarkGetResults());
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// End of file
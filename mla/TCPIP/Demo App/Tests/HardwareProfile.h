@@ -0,0 +1,23 @@
+/**
+ * @file HardwareProfile.h
+ * @author Seb Madgwick
+ * @brief Host replacement for the target HardwareProfile.h so that modules
+ * that do not access the hardware may be compiled natively.  This file is
+ * found before the target file because the Tests directory is first in the
+ * include path of the host build.
+ */
+
+#ifndef HARDWARE_PROFILE_H
+#define HARDWARE_PROFILE_H
+
+//------------------------------------------------------------------------------
+// Definitions - Clock frequency values
+
+#define SYSCLK 80000000ul
+
+#define GetSystemClock() (SYSCLK)
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
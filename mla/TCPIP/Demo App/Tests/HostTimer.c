@@ -0,0 +1,55 @@
+/**
+ * @file HostTimer.c
+ * @author Seb Madgwick
+ * @brief Host implementation of the Timer module.  The monotonic clock of the
+ * host is scaled to TIMER_TICKS_PER_SECOND so that timing calculations are
+ * the same as on the target.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Timer/Timer.h"
+#include <time.h> // clock_gettime
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Initialises module.  Nothing is required on the host.
+ */
+void TimerInitialise() {
+}
+
+/**
+ * @brief Gets 32-bit timer value.
+ * @return 32-bit timer value.
+ */
+Ticks32 TimerGetTicks32() {
+    return TimerGetTicks64().ticks32;
+}
+
+/**
+ * @brief Gets 64-bit timer value.
+ * @return 64-bit timer value.
+ */
+Ticks64 TimerGetTicks64() {
+    struct timespec timespec;
+    clock_gettime(CLOCK_MONOTONIC, &timespec);
+    Ticks64 ticks64;
+    ticks64.value = ((uint64_t) timespec.tv_sec * TIMER_TICKS_PER_SECOND) + (((uint64_t) timespec.tv_nsec * TIMER_TICKS_PER_SECOND) / 1000000000ull);
+    return ticks64;
+}
+
+/**
+ * @brief Blocking delay in milliseconds.
+ * @param milliseconds Delay in milliseconds.
+ */
+void TimerDelay(uint32_t milliseconds) {
+    const Ticks64 previousTicks = TimerGetTicks64();
+    while ((TimerGetTicks64().value - previousTicks.value) < ((uint64_t) milliseconds * (TIMER_TICKS_PER_SECOND / 1000))) {
+    }
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,465 @@
+/**
+ * @file OscAddressTest.c
+ * @author Seb Madgwick
+ * @brief Host differential test of OscAddressMatch and OscAddressMatchPartial
+ * against the previous recursive implementation.
+ *
+ * The previous implementation is included below as the reference, unchanged
+ * except for the Reference prefix and a guard at each point where it
+ * advances through the target OSC address.  The guard detects the two cases
+ * where the reference does not complete: a match beyond the terminating null
+ * character of the target OSC address and a zero-length match repeated
+ * indefinitely.  The result of the reference is undefined in these cases and
+ * so they are counted but not compared.
+ *
+ * Pseudorandom OSC address patterns are generated from tokens containing each
+ * special character, including unbalanced brackets and curly braces.
+ * Pseudorandom target OSC addresses are generated from a small alphabet so
+ * that many pairs match.  A fixed seed is used so that the test is
+ * deterministic.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h> // bool, true, false
+#include <stdint.h> // uint64_t
+#include <stdio.h> // printf
+#include <string.h> // strcat, strlen, strncmp
+#include "Osc99/Osc99.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of pseudorandom OSC address pattern and target OSC address
+ * pairs tested in each of exact and partial modes.
+ */
+#define NUMBER_OF_PAIRS 2000000
+
+/**
+ * @brief Maximum number of tokens within a generated OSC address pattern.
+ */
+#define MAX_NUMBER_OF_TOKENS 12
+
+/**
+ * @brief Maximum length of a generated target OSC address.
+ */
+#define MAX_ADDRESS_LENGTH 12
+
+/**
+ * @brief Number of steps after which the reference is considered not to
+ * complete.
+ */
+#define MAX_REFERENCE_STEPS 10000
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void TestPair(const char* const oscAddressPattern, const char* const oscAddress, const bool isPartial);
+static void GeneratePattern(char* const destination);
+static void GenerateAddress(char* const destination);
+static uint64_t GetRandom();
+static bool IsReferenceDefined(const char* const oscAddress);
+static bool ReferenceMatch(const char* oscAddressPattern, const char* const oscAddress, const bool isPartial);
+static bool ReferenceMatchLiteral(const char* oscAddressPattern, const char* oscAddress, const bool isPartial);
+static bool ReferenceMatchExpression(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
+static bool ReferenceMatchStar(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
+static bool ReferenceMatchCharacter(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
+static bool ReferenceMatchBrackets(const char* * const oscAddressPattern, const char* * const oscAddress);
+static bool ReferenceMatchCurlyBraces(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static const char* const patternTokens[] = {
+    "/", "/", "/", "a", "b", "c", "ab", "?", "*", "**", "[ab]", "[!a]", "[a-c]", "[c-a]", "[a-]", "[!]",
+    "{a,b}", "{ab,a}", "{a,ab}", "{,a}", "{a,}", "{}", "{b,c/}", "[", "]", "{", "}", ",", "-", "!",
+};
+#define NUMBER_OF_PATTERN_TOKENS (sizeof (patternTokens) / sizeof (patternTokens[0]))
+
+static const char addressCharacters[] = "/abc";
+
+static uint64_t randomState = 0x2545F4914F6CDD1Dull;
+static const char* referenceAddressEnd; // terminating null character of target OSC address
+static int referenceSteps;
+static bool isReferenceUndefined;
+static int numberOfPairs;
+static int numberOfMatches;
+static int numberOfUndefined;
+static int numberOfFailures;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Test entry point.
+ * @return 0 if all tests passed.
+ */
+int main(void) {
+    static const char* const pairs[][2] = {
+        {"/a*b*c*d*", "/aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaabcd"},
+        {"/sensor/{imu,mag}/*scop?/[a-z]*", "/sensor/imu/gyroscope/x"},
+        {"/{in,out,,}puts/enable", "/puts/enable"},
+        {"/abc[!d-hijk[p-l]qrst", "/abcXqrst"},
+        {"/*", "/"},
+        {"", ""},
+    };
+    int index;
+    for (index = 0; index < (int) (sizeof (pairs) / sizeof (pairs[0])); index++) {
+        TestPair(pairs[index][0], pairs[index][1], false);
+        TestPair(pairs[index][0], pairs[index][1], true);
+    }
+    for (index = 0; index < NUMBER_OF_PAIRS; index++) {
+        char oscAddressPattern[MAX_NUMBER_OF_TOKENS * 8];
+        char oscAddress[MAX_ADDRESS_LENGTH + 1];
+        GeneratePattern(oscAddressPattern);
+        GenerateAddress(oscAddress);
+        TestPair(oscAddressPattern, oscAddress, false);
+        TestPair(oscAddressPattern, oscAddress, true);
+    }
+    printf("%d pairs, %d matches, %d undefined, %d failures\n", numberOfPairs, numberOfMatches, numberOfUndefined, numberOfFailures);
+    return numberOfFailures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Compares the result of the matcher with that of the reference.  A
+ * message is printed for each failure.
+ * @param oscAddressPattern OSC address pattern.
+ * @param oscAddress Target OSC address.
+ * @param isPartial Flag indicating if a partial match is acceptable.
+ */
+static void TestPair(const char* const oscAddressPattern, const char* const oscAddress, const bool isPartial) {
+    numberOfPairs++;
+    const bool expected = ReferenceMatch(oscAddressPattern, oscAddress, isPartial);
+    if (isReferenceUndefined == true) {
+        numberOfUndefined++;
+        return;
+    }
+    const bool result = isPartial ? OscAddressMatchPartial(oscAddressPattern, oscAddress) : OscAddressMatch(oscAddressPattern, oscAddress);
+    if (result != expected) {
+        printf("FAIL %s \"%s\" \"%s\": %d, expected %d\n", isPartial ? "partial" : "exact", oscAddressPattern, oscAddress, result, expected);
+        numberOfFailures++;
+    }
+    if (result == true) {
+        numberOfMatches++;
+    }
+}
+
+/**
+ * @brief Generates a pseudorandom OSC address pattern.  Most patterns start
+ * with '/' as required by OSC.
+ * @param destination Destination.
+ */
+static void GeneratePattern(char* const destination) {
+    destination[0] = '\0';
+    if ((GetRandom() % 8) != 0) {
+        strcat(destination, "/");
+    }
+    const int numberOfTokens = GetRandom() % (MAX_NUMBER_OF_TOKENS + 1);
+    int index;
+    for (index = 0; index < numberOfTokens; index++) {
+        strcat(destination, patternTokens[GetRandom() % NUMBER_OF_PATTERN_TOKENS]);
+    }
+}
+
+/**
+ * @brief Generates a pseudorandom target OSC address.
+ * @param destination Destination.
+ */
+static void GenerateAddress(char* const destination) {
+    const int length = GetRandom() % (MAX_ADDRESS_LENGTH + 1);
+    int index;
+    for (index = 0; index < length; index++) {
+        destination[index] = addressCharacters[GetRandom() % (sizeof (addressCharacters) - 1)];
+    }
+    destination[length] = '\0';
+}
+
+/**
+ * @brief Returns the next value of a xorshift64* pseudorandom sequence.
+ * @return Pseudorandom value.
+ */
+static uint64_t GetRandom() {
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return (randomState * 0x2545F4914F6CDD1Dull) >> 32;
+}
+
+/**
+ * @brief Guard called by the reference each time it advances.  The result of
+ * the reference is undefined if the target OSC address pointer passes the
+ * terminating null character or too many steps are taken.
+ * @param oscAddress Target OSC address pointer.
+ * @return true if the reference may continue.
+ */
+static bool IsReferenceDefined(const char* const oscAddress) {
+    if ((oscAddress > referenceAddressEnd) || (++referenceSteps > MAX_REFERENCE_STEPS)) {
+        isReferenceUndefined = true;
+    }
+    return isReferenceUndefined == false;
+}
+
+/**
+ * @brief Matches an OSC address pattern with a target OSC address using the
+ * reference.
+ * @param oscAddressPattern OSC address pattern.
+ * @param oscAddress Target OSC address.
+ * @param isPartial Flag indicating if a partial match is acceptable.
+ * @return true if the OSC address pattern and target OSC address match.  The
+ * result is undefined if isReferenceUndefined is true.
+ */
+static bool ReferenceMatch(const char* oscAddressPattern, const char* const oscAddress, const bool isPartial) {
+    referenceAddressEnd = oscAddress + strlen(oscAddress);
+    referenceSteps = 0;
+    isReferenceUndefined = false;
+    return ReferenceMatchLiteral(oscAddressPattern, oscAddress, isPartial);
+}
+
+//------------------------------------------------------------------------------
+// Functions - Reference
+
+static bool ReferenceMatchLiteral(const char* oscAddressPattern, const char* oscAddress, const bool isPartial) {
+    while (*oscAddressPattern != '\0') {
+        if (*oscAddress == '\0') {
+            if (isPartial) {
+                return true;
+            } else {
+                return ReferenceMatchExpression(&oscAddressPattern, &oscAddress, isPartial); // handle trailing 'zero character' expressions
+            }
+            return false; // fail: OSC address pattern too short
+        }
+        switch (*oscAddressPattern) {
+            case '?':
+            case '*':
+            case '[':
+            case '{':
+                return ReferenceMatchExpression(&oscAddressPattern, &oscAddress, isPartial);
+            default:
+                if (*oscAddressPattern != *oscAddress) {
+                    return false; // fail: character mismatch
+                }
+                break;
+        }
+        oscAddressPattern++;
+        oscAddress++;
+    }
+    if (*oscAddress != '\0') {
+        return false; // fail: OSC address pattern too long
+    }
+    return true;
+}
+
+static bool ReferenceMatchExpression(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial) {
+    while (**oscAddressPattern != '\0') {
+        if (IsReferenceDefined(*oscAddress) == false) {
+            return false;
+        }
+        if (**oscAddress == '\0') {
+            if (isPartial) {
+                return true;
+            }
+        }
+        if (**oscAddressPattern == '*') {
+            if (!ReferenceMatchStar(oscAddressPattern, oscAddress, isPartial)) {
+                return false; // fail: unable to match star sequence
+            }
+        } else {
+            if (!ReferenceMatchCharacter(oscAddressPattern, oscAddress, isPartial)) {
+                return false; // fail: unable to match single character, bracketed list or curly braced list
+            }
+        }
+    }
+    if (IsReferenceDefined(*oscAddress) == false) {
+        return false;
+    }
+    if (**oscAddress != '\0') {
+        return false; // fail: OSC address pattern too long
+    }
+    return true;
+}
+
+static bool ReferenceMatchStar(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial) {
+
+    // Advance OSC address pattern pointer to character proceeding star(s)
+    while (**oscAddressPattern == '*') {
+        (*oscAddressPattern)++;
+    }
+
+    // Advance OSC address pattern pointer to end of part if star is last character
+    if (**oscAddressPattern == '/' || **oscAddressPattern == '\0') {
+        while (**oscAddress != '/' && **oscAddress != '\0') {
+            (*oscAddress)++;
+        }
+        return true;
+    }
+
+    // Attempt to match remainder of expression for each possible star match
+    do {
+        const char* oscAddressPatternCache = *oscAddressPattern; // cache character oscAddress proceeding star
+
+        // Advance OSC address pattern to next match of character proceeding star
+        while (!ReferenceMatchCharacter(oscAddressPattern, oscAddress, isPartial)) {
+            (*oscAddress)++;
+            if (IsReferenceDefined(*oscAddress) == false) {
+                return false;
+            }
+            if (**oscAddress == '/' || **oscAddress == '\0') {
+                if (isPartial && **oscAddress == '\0') {
+                    return true;
+                }
+                return false; // fail: OSC address pattern part ended before match
+            }
+        }
+        const char* oscAddressCache = (*oscAddress); // cache character oscAddress proceeding current star match
+
+        // Attempt to match remainder of expression
+        if (ReferenceMatchExpression(oscAddressPattern, oscAddress, isPartial)) { // potentially recursive
+            return true;
+        } else {
+            if (isReferenceUndefined == true) {
+                return false;
+            }
+            *oscAddressPattern = oscAddressPatternCache;
+            *oscAddress = oscAddressCache;
+        }
+    } while (true);
+}
+
+static bool ReferenceMatchCharacter(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial) {
+    if (IsReferenceDefined(*oscAddress) == false) {
+        return false;
+    }
+    const char* oscAddressPatternCache = *oscAddressPattern;
+    const char* oscAddressCache = *oscAddress;
+    switch (**oscAddressPattern) {
+        case '[':
+            if (ReferenceMatchBrackets(oscAddressPattern, oscAddress)) {
+                return true;
+            }
+            break;
+        case ']':
+            break; // fail: unbalanced brackets
+        case '{':
+            if (ReferenceMatchCurlyBraces(oscAddressPattern, oscAddress, isPartial)) {
+                return true;
+            }
+            break;
+        case '}':
+            break; // fail: unbalanced curly braces
+        default:
+            if (**oscAddressPattern == **oscAddress || **oscAddressPattern == '?') {
+                (*oscAddressPattern)++;
+                (*oscAddress)++;
+                return true;
+            }
+            break;
+    }
+    *oscAddressPattern = oscAddressPatternCache;
+    *oscAddress = oscAddressCache;
+    return false;
+}
+
+static bool ReferenceMatchBrackets(const char* * const oscAddressPattern, const char* * const oscAddress) {
+    (*oscAddressPattern)++; // increment past opening bracket
+
+    // Check if list is negated
+    bool negatedList = false;
+    if (**oscAddressPattern == '!') {
+        negatedList = true;
+        (*oscAddressPattern)++; // increment past '!'
+    }
+
+    // Match each character in list
+    bool match = negatedList;
+    while (**oscAddressPattern != ']') {
+        if (**oscAddressPattern == '/' || **oscAddressPattern == '\0') {
+            return false; // fail: unbalanced brackets
+        }
+
+        // If character is part of hyphenated range
+        if (*(*oscAddressPattern + 1) == '-' && *(*oscAddressPattern + 2) != ']') {
+            if (*(*oscAddressPattern + 2) == '/' || *(*oscAddressPattern + 2) == '\0') {
+                return false; // fail: unbalanced brackets
+            }
+
+            // Handle acceding/descending range
+            char lowerChar = **oscAddressPattern;
+            char upperChar = *(*oscAddressPattern + 2);
+            if (lowerChar > upperChar) {
+                lowerChar = *(*oscAddressPattern + 2);
+                upperChar = **oscAddressPattern;
+            }
+
+            // Check if target character in range
+            if (**oscAddress >= lowerChar && **oscAddress <= upperChar) {
+                if (negatedList) {
+                    match = false; // fail: character matched in negated list
+                } else {
+                    match = true;
+                }
+            }
+            (*oscAddressPattern) += 3; // increment past hyphenated characters
+        } else {
+
+            // Else match single character
+            if (**oscAddressPattern == **oscAddress) {
+                if (negatedList) {
+                    match = false; // fail: character matched in negated list
+                } else {
+                    match = true;
+                }
+            }
+            (*oscAddressPattern)++;
+        }
+    }
+    (*oscAddressPattern)++; // increment past closing bracket
+    (*oscAddress)++; // increment past matched character
+    return match;
+}
+
+static bool ReferenceMatchCurlyBraces(const char* * const oscAddressPattern, const char* * const oscAddress, const bool isPartial) {
+    const char* endOfSubstring = *oscAddressPattern;
+    size_t matchedSubStringLength = 0;
+    bool match = false;
+    while (**oscAddressPattern != '}') {
+        if (**oscAddressPattern == '/' || **oscAddressPattern == '\0') {
+            return false; // fail: unbalanced curly braces
+        }
+
+        // Advance to end of substring
+        while (*endOfSubstring != ',' && *endOfSubstring != '}') {
+            if (*endOfSubstring == '/' || *endOfSubstring == '\0') {
+                return false; // fail: unbalanced curly braces
+            }
+            endOfSubstring++;
+        }
+
+        // Determine substring length
+        (*oscAddressPattern)++; // increment past '{' or ','
+        size_t subStringLength = endOfSubstring - *oscAddressPattern;
+        if (isPartial) {
+            size_t oscAddressLength = strlen(*oscAddress);
+            if (subStringLength > oscAddressLength) {
+                subStringLength = oscAddressLength; // limit length to not exceed partial target
+            }
+        }
+
+        // Match substring
+        if (strncmp(*oscAddressPattern, *oscAddress, subStringLength) == 0) {
+            match = true;
+            if (subStringLength > matchedSubStringLength) {
+                matchedSubStringLength = subStringLength;
+            }
+        }
+        *oscAddressPattern = endOfSubstring; // advance to next ',' or '}'
+        endOfSubstring++; // increment past ',' or '}'
+    }
+    (*oscAddressPattern)++; // increment past '{' or ','
+    *oscAddress += matchedSubStringLength; // increment past matched substring
+    return match;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,227 @@
+/**
+ * @file OscTypeTest.c
+ * @author Seb Madgwick
+ * @brief Host test of decoding into OSC message and OSC packet types defined
+ * using OSC_MESSAGE_TYPE and OSC_PACKET_TYPE.
+ *
+ * An OSC message containing NUMBER_OF_ARGUMENTS int32 arguments is decoded
+ * into types smaller and larger than the message.  Each type is followed by a
+ * guard that must not be modified.  Decoding into a smaller type must fail and
+ * decoding into a larger type must succeed and reproduce the message.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <stdbool.h> // bool, true, false
+#include <stdint.h> // int32_t, uint8_t
+#include <stdio.h> // printf
+#include <string.h> // memcmp, memset
+#include "Osc99/Osc99.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of int32 arguments in the OSC message.
+ */
+#define NUMBER_OF_ARGUMENTS 4
+
+/**
+ * @brief Size of the guard following each type and the value of each byte.
+ */
+#define GUARD_SIZE 64
+#define GUARD_VALUE 0xA5
+
+/**
+ * @brief Macro that defines a type containing an OSC message or OSC packet
+ * type followed by a guard.
+ */
+#define GUARDED_TYPE(name, type) \
+    typedef struct { \
+        type value; \
+        uint8_t guard[GUARD_SIZE]; \
+    } name
+
+/**
+ * @brief OSC message types with too few arguments, too small an argument
+ * storage and enough capacity for the OSC message.
+ */
+OSC_MESSAGE_TYPE(FewArgumentsMessage, 2, 16);
+OSC_MESSAGE_TYPE(SmallArgumentsMessage, NUMBER_OF_ARGUMENTS, 8);
+OSC_MESSAGE_TYPE(LargeMessage, 8, 64);
+GUARDED_TYPE(GuardedFewArgumentsMessage, FewArgumentsMessage);
+GUARDED_TYPE(GuardedSmallArgumentsMessage, SmallArgumentsMessage);
+GUARDED_TYPE(GuardedLargeMessage, LargeMessage);
+
+/**
+ * @brief OSC packet types smaller and larger than the OSC message.
+ */
+OSC_PACKET_TYPE(SmallPacket, 16);
+OSC_PACKET_TYPE(LargePacket, 64);
+GUARDED_TYPE(GuardedSmallPacket, SmallPacket);
+GUARDED_TYPE(GuardedLargePacket, LargePacket);
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void TestMessage(const char* const name, OscMessage * const oscMessage, const uint8_t * const guard, const bool isLarger);
+static void TestPacket(const char* const name, OscPacket * const oscPacket, const uint8_t * const guard, const bool isLarger);
+static void ProcessMessage(const OscTimeTag * const oscTimeTag, OscMessage * const oscMessage);
+static bool IsGuardIntact(const uint8_t * const guard);
+static void Check(const char* const name, const char* const description, const bool isPass);
+
+//------------------------------------------------------------------------------
+// Variables
+
+static OscMessage sourceMessage;
+static char source[64];
+static size_t sourceSize;
+static int numberOfMessagesProcessed;
+static int numberOfFailures;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Test entry point.
+ * @return 0 if all tests passed.
+ */
+int main(void) {
+    OscMessageInitialise(&sourceMessage, "/test");
+    int32_t argument;
+    for (argument = 0; argument < NUMBER_OF_ARGUMENTS; argument++) {
+        OscMessageAddInt32(&sourceMessage, argument);
+    }
+    if (OscMessageToCharArray(&sourceMessage, &sourceSize, source, sizeof (source)) != 0) {
+        printf("Unable to create source\n");
+        return 1;
+    }
+
+    GuardedFewArgumentsMessage fewArgumentsMessage;
+    memset(fewArgumentsMessage.guard, GUARD_VALUE, GUARD_SIZE);
+    OSC_MESSAGE_INITIALISE(&fewArgumentsMessage.value, "");
+    TestMessage("FewArgumentsMessage", OSC_MESSAGE(&fewArgumentsMessage.value), fewArgumentsMessage.guard, false);
+
+    GuardedSmallArgumentsMessage smallArgumentsMessage;
+    memset(smallArgumentsMessage.guard, GUARD_VALUE, GUARD_SIZE);
+    OSC_MESSAGE_INITIALISE(&smallArgumentsMessage.value, "");
+    TestMessage("SmallArgumentsMessage", OSC_MESSAGE(&smallArgumentsMessage.value), smallArgumentsMessage.guard, false);
+
+    GuardedLargeMessage largeMessage;
+    memset(largeMessage.guard, GUARD_VALUE, GUARD_SIZE);
+    OSC_MESSAGE_INITIALISE(&largeMessage.value, "");
+    TestMessage("LargeMessage", OSC_MESSAGE(&largeMessage.value), largeMessage.guard, true);
+
+    GuardedSmallPacket smallPacket;
+    memset(smallPacket.guard, GUARD_VALUE, GUARD_SIZE);
+    OSC_PACKET_INITIALISE(&smallPacket.value);
+    TestPacket("SmallPacket", OSC_PACKET(&smallPacket.value), smallPacket.guard, false);
+
+    GuardedLargePacket largePacket;
+    memset(largePacket.guard, GUARD_VALUE, GUARD_SIZE);
+    OSC_PACKET_INITIALISE(&largePacket.value);
+    TestPacket("LargePacket", OSC_PACKET(&largePacket.value), largePacket.guard, true);
+
+    printf("%d failures\n", numberOfFailures);
+    return numberOfFailures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Decodes the source into an OSC message type.
+ * @param name Name of the OSC message type.
+ * @param oscMessage Address of the initialised OSC message type.
+ * @param guard Address of the guard following the OSC message type.
+ * @param isLarger True if the OSC message type is large enough for the source.
+ */
+static void TestMessage(const char* const name, OscMessage * const oscMessage, const uint8_t * const guard, const bool isLarger) {
+    const size_t maxNumberOfArguments = oscMessage->maxNumberOfArguments;
+    const size_t maxArgumentsSize = oscMessage->maxArgumentsSize;
+    const int result = OscMessageInitialiseFromCharArray(oscMessage, source, sourceSize);
+    Check(name, "result", (result == 0) == isLarger);
+    Check(name, "capacity retained", (oscMessage->maxNumberOfArguments == maxNumberOfArguments) && (oscMessage->maxArgumentsSize == maxArgumentsSize));
+    Check(name, "guard intact", IsGuardIntact(guard));
+    if (isLarger == false) {
+        return;
+    }
+    char destination[sizeof (source)];
+    size_t destinationSize;
+    Check(name, "encode", OscMessageToCharArray(oscMessage, &destinationSize, destination, sizeof (destination)) == 0);
+    Check(name, "contents", (destinationSize == sourceSize) && (memcmp(destination, source, sourceSize) == 0));
+    int32_t expected;
+    for (expected = 0; expected < NUMBER_OF_ARGUMENTS; expected++) {
+        int32_t argument;
+        Check(name, "argument", (OscMessageGetInt32(oscMessage, &argument) == 0) && (argument == expected));
+    }
+}
+
+/**
+ * @brief Decodes the source into an OSC packet type from both a char array and
+ * the OSC message contents.
+ * @param name Name of the OSC packet type.
+ * @param oscPacket Address of the initialised OSC packet type.
+ * @param guard Address of the guard following the OSC packet type.
+ * @param isLarger True if the OSC packet type is large enough for the source.
+ */
+static void TestPacket(const char* const name, OscPacket * const oscPacket, const uint8_t * const guard, const bool isLarger) {
+    const size_t maxSize = oscPacket->maxSize;
+    int result = OscPacketInitialiseFromCharArray(oscPacket, source, sourceSize);
+    Check(name, "char array result", (result == 0) == isLarger);
+    Check(name, "char array capacity retained", oscPacket->maxSize == maxSize);
+    Check(name, "char array guard intact", IsGuardIntact(guard));
+    if (isLarger == true) {
+        Check(name, "char array contents", (oscPacket->size == sourceSize) && (memcmp(oscPacket->contents, source, sourceSize) == 0));
+        numberOfMessagesProcessed = 0;
+        oscPacket->processMessage = ProcessMessage;
+        Check(name, "process messages", (OscPacketProcessMessages(oscPacket) == 0) && (numberOfMessagesProcessed == 1));
+    }
+    result = OscPacketInitialiseFromContents(oscPacket, &sourceMessage);
+    Check(name, "contents result", (result == 0) == isLarger);
+    Check(name, "contents capacity retained", oscPacket->maxSize == maxSize);
+    Check(name, "contents guard intact", IsGuardIntact(guard));
+    if (isLarger == true) {
+        Check(name, "contents contents", (oscPacket->size == sourceSize) && (memcmp(oscPacket->contents, source, sourceSize) == 0));
+    }
+}
+
+/**
+ * @brief Counts each OSC message processed by OscPacketProcessMessages.
+ * @param oscTimeTag OSC time tag associated with the OSC message.
+ * @param oscMessage Address of the OSC message.
+ */
+static void ProcessMessage(const OscTimeTag * const oscTimeTag, OscMessage * const oscMessage) {
+    if (OscAddressMatch(oscMessage->oscAddressPattern, "/test") == true) {
+        numberOfMessagesProcessed++;
+    }
+}
+
+/**
+ * @brief Returns true if no byte of a guard has been modified.
+ * @param guard Address of the guard.
+ * @return true if no byte of the guard has been modified.
+ */
+static bool IsGuardIntact(const uint8_t * const guard) {
+    int index;
+    for (index = 0; index < GUARD_SIZE; index++) {
+        if (guard[index] != GUARD_VALUE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints and counts a failed check.
+ * @param name Name of the type.
+ * @param description Description of the check.
+ * @param isPass True if the check passed.
+ */
+static void Check(const char* const name, const char* const description, const bool isPass) {
+    if (isPass == false) {
+        printf("%s: %s FAIL\n", name, description);
+        numberOfFailures++;
+    }
+}
+
+//------------------------------------------------------------------------------
+// End of file
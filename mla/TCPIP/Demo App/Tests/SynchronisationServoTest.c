@@ -0,0 +1,255 @@
+/**
+ * @file SynchronisationServoTest.c
+ * @author Seb Madgwick
+ * @brief Deterministic host simulation of the clock servo in
+ * Synchronisation.c compared to the servo without the minimum delay filter and
+ * to the previous algorithm.
+ *
+ * A simulated master clock runs 30 ppm faster or slower than the timer.
+ * Synchronisation messages are sent at 1, 10 and 100 Hz and each arrives after
+ * a latency of MIN_LATENCY plus a pseudorandom jitter of up to MAX_JITTER.  The
+ * slave clock is compared to the master clock at several points between each
+ * update.  The mean error is removed because neither algorithm can observe
+ * the latency.  The RMS and maximum errors are printed for each algorithm.
+ * The test fails if either error of the servo exceeds that of the previous
+ * algorithm or is not less than that of the servo without the filter.
+ *
+ * The previous algorithm is reproduced here as the reference.  It steps the
+ * slave clock forwards to the master clock and ignores updates that are behind
+ * the slave clock by less than THRESHOLD.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <math.h> // fmax, fmin, INFINITY, sqrt
+#include <stdbool.h> // bool, true, false
+#include <stdint.h> // int64_t, uint64_t
+#include <stdio.h> // printf
+#include "Synchronisation/Synchronisation.h"
+#include "SynchronisationUnfiltered.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Simulation duration and time after which the error is measured in
+ * seconds.
+ */
+#define DURATION 600
+#define SETTLING_TIME 60
+
+/**
+ * @brief Minimum latency and maximum jitter of each synchronisation message in
+ * timer ticks.
+ */
+#define MIN_LATENCY (TIMER_TICKS_PER_SECOND / 10000) // 100 us
+#define MAX_JITTER (TIMER_TICKS_PER_SECOND / 20000) // 50 us
+
+/**
+ * @brief Number of points between each update at which the error is measured.
+ */
+#define NUMBER_OF_POINTS 10
+
+/**
+ * @brief Threshold (in timer ticks) of the previous algorithm.
+ */
+#define THRESHOLD (TIMER_TICKS_PER_SECOND / 2)
+
+/**
+ * @brief Result of a simulation.
+ */
+typedef struct {
+    double sum;
+    double sumOfSquares;
+    double min;
+    double max;
+    double rmsError;
+    double maxError;
+} Result;
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static void Simulate(const int skewPpm, const int rate, Result * const servo, Result * const unfiltered, Result * const reference);
+static void ReferenceUpdate(const uint64_t observedMasterClock, const uint64_t timeOfArrival);
+static uint64_t GetMasterClock(const uint64_t ticks, const int skewPpm);
+static uint64_t TicksToOscTimeTag(const uint64_t ticks);
+static uint64_t OscTimeTagToTicks(const uint64_t oscTimeTag);
+static void AddError(Result * const result, const int64_t error);
+static void CalculateErrors(Result * const result);
+static uint64_t GetRandom();
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint64_t randomState;
+static uint64_t referenceSlaveClockOffset;
+static int numberOfErrors;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Test entry point.
+ * @return 0 if all tests passed.
+ */
+int main(void) {
+    static const int skews[] = {30, -30};
+    static const int rates[] = {1, 10, 100};
+    int numberOfFailures = 0;
+    printf("skew (ppm)  rate (Hz)  previous RMS (max) us  unfiltered RMS (max) us  servo RMS (max) us\n");
+    int skewIndex;
+    for (skewIndex = 0; skewIndex < (sizeof (skews) / sizeof (skews[0])); skewIndex++) {
+        int rateIndex;
+        for (rateIndex = 0; rateIndex < (sizeof (rates) / sizeof (rates[0])); rateIndex++) {
+            Result servo;
+            Result unfiltered;
+            Result reference;
+            Simulate(skews[skewIndex], rates[rateIndex], &servo, &unfiltered, &reference);
+            const bool pass = (servo.rmsError <= reference.rmsError) && (servo.maxError <= reference.maxError) && (servo.rmsError < unfiltered.rmsError) && (servo.maxError < unfiltered.maxError);
+            printf("%+10d  %9d  %10.1f (%8.1f)  %12.1f (%8.1f)  %9.1f (%6.1f)%s\n", skews[skewIndex], rates[rateIndex], reference.rmsError, reference.maxError, unfiltered.rmsError, unfiltered.maxError, servo.rmsError, servo.maxError, pass ? "" : "  FAIL");
+            if (pass == false) {
+                numberOfFailures++;
+            }
+        }
+    }
+    printf("%d failures\n", numberOfFailures);
+    return numberOfFailures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Runs a simulation for the servo, the servo without the filter and the
+ * previous algorithm.  Each receives the same updates and the same
+ * pseudorandom sequence is used for each simulation.
+ * @param skewPpm Frequency of the master clock relative to the timer in ppm.
+ * @param rate Synchronisation rate in Hz.
+ * @param servo Address of the result of the servo.
+ * @param unfiltered Address of the result of the servo without the filter.
+ * @param reference Address of the result of the previous algorithm.
+ */
+static void Simulate(const int skewPpm, const int rate, Result * const servo, Result * const unfiltered, Result * const reference) {
+    SynchronisationInitialise();
+    UnfilteredSynchronisationInitialise();
+    referenceSlaveClockOffset = 0;
+    randomState = 0x9E3779B97F4A7C15ull;
+    const Result initialResult = {.min = INFINITY, .max = -INFINITY};
+    *servo = initialResult;
+    *unfiltered = initialResult;
+    *reference = initialResult;
+    numberOfErrors = 0;
+    const uint64_t interval = TIMER_TICKS_PER_SECOND / rate;
+    uint64_t timeOfSending;
+    for (timeOfSending = 0; timeOfSending < ((uint64_t) DURATION * TIMER_TICKS_PER_SECOND); timeOfSending += interval) {
+
+        // Update
+        const uint64_t observedMasterClock = GetMasterClock(timeOfSending, skewPpm);
+        const uint64_t timeOfArrival = timeOfSending + MIN_LATENCY + (GetRandom() % (MAX_JITTER + 1));
+        const OscTimeTag oscTimeTag = {.value = TicksToOscTimeTag(observedMasterClock)};
+        const Ticks64 ticks64 = {.value = timeOfArrival};
+        SynchronisationUpdate(oscTimeTag, ticks64);
+        UnfilteredSynchronisationUpdate(oscTimeTag, ticks64);
+        ReferenceUpdate(observedMasterClock, timeOfArrival);
+
+        // Measure error until next update
+        if (timeOfSending < ((uint64_t) SETTLING_TIME * TIMER_TICKS_PER_SECOND)) {
+            continue;
+        }
+        int point;
+        for (point = 0; point < NUMBER_OF_POINTS; point++) {
+            const uint64_t ticks = timeOfArrival + ((interval * point) / NUMBER_OF_POINTS);
+            const int64_t expected = (int64_t) GetMasterClock(ticks, skewPpm);
+            const Ticks64 ticksToConvert = {.value = ticks};
+            AddError(servo, (int64_t) OscTimeTagToTicks(SynchronisationTicksToOscTimeTag(ticksToConvert).value) - expected);
+            AddError(unfiltered, (int64_t) OscTimeTagToTicks(UnfilteredSynchronisationTicksToOscTimeTag(ticksToConvert).value) - expected);
+            AddError(reference, (int64_t) (ticks + referenceSlaveClockOffset) - expected);
+            numberOfErrors++;
+        }
+    }
+    CalculateErrors(servo);
+    CalculateErrors(unfiltered);
+    CalculateErrors(reference);
+}
+
+/**
+ * @brief Updates the previous algorithm with the time received from the
+ * master.
+ * @param observedMasterClock Master clock received from the master.
+ * @param timeOfArrival Timer ticks value when the master clock was received.
+ */
+static void ReferenceUpdate(const uint64_t observedMasterClock, const uint64_t timeOfArrival) {
+    const uint64_t slowClock = timeOfArrival + referenceSlaveClockOffset;
+    if (observedMasterClock < slowClock) {
+        if ((slowClock - observedMasterClock) < THRESHOLD) {
+            return; // ignore update if behind slave time and within threshold
+        }
+    }
+    referenceSlaveClockOffset = observedMasterClock - timeOfArrival;
+}
+
+/**
+ * @brief Returns the master clock at a timer ticks value.  The master clock
+ * starts one hour ahead of the timer.
+ * @param ticks Timer ticks value.
+ * @param skewPpm Frequency of the master clock relative to the timer in ppm.
+ * @return Master clock in timer ticks.
+ */
+static uint64_t GetMasterClock(const uint64_t ticks, const int skewPpm) {
+    return (3600ull * TIMER_TICKS_PER_SECOND) + ticks + (uint64_t) (((__int128) ticks * skewPpm) / 1000000);
+}
+
+/**
+ * @brief Converts ticks to an OSC time tag calculated with 128-bit arithmetic.
+ * @param ticks Ticks.
+ * @return OSC time tag value.
+ */
+static uint64_t TicksToOscTimeTag(const uint64_t ticks) {
+    return (uint64_t) (((unsigned __int128) ticks << 32) / TIMER_TICKS_PER_SECOND);
+}
+
+/**
+ * @brief Converts an OSC time tag to ticks calculated with 128-bit arithmetic.
+ * @param oscTimeTag OSC time tag value.
+ * @return Ticks.
+ */
+static uint64_t OscTimeTagToTicks(const uint64_t oscTimeTag) {
+    return (uint64_t) (((unsigned __int128) oscTimeTag * TIMER_TICKS_PER_SECOND) >> 32);
+}
+
+/**
+ * @brief Adds an error to a result.
+ * @param result Address of the result.
+ * @param error Error in timer ticks.
+ */
+static void AddError(Result * const result, const int64_t error) {
+    const double errorUs = ((double) error * 1000000.0) / TIMER_TICKS_PER_SECOND;
+    result->sum += errorUs;
+    result->sumOfSquares += errorUs * errorUs;
+    result->min = fmin(result->min, errorUs);
+    result->max = fmax(result->max, errorUs);
+}
+
+/**
+ * @brief Calculates the RMS and maximum errors about the mean error.
+ * @param result Address of the result.
+ */
+static void CalculateErrors(Result * const result) {
+    const double mean = result->sum / numberOfErrors;
+    result->rmsError = sqrt(fmax((result->sumOfSquares / numberOfErrors) - (mean * mean), 0.0));
+    result->maxError = fmax(result->max - mean, mean - result->min);
+}
+
+/**
+ * @brief Returns the next value of a xorshift64* pseudorandom sequence.  The
+ * seed is reset for each simulation so that the test is deterministic.
+ * @return Pseudorandom value.
+ */
+static uint64_t GetRandom() {
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 0x2545F4914F6CDD1Dull;
+}
+
+//------------------------------------------------------------------------------
+// End of file
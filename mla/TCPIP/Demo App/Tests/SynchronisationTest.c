@@ -0,0 +1,171 @@
+/**
+ * @file SynchronisationTest.c
+ * @author Seb Madgwick
+ * @brief Host test of the integer conversions between timer ticks and OSC time
+ * tags in Synchronisation.c.
+ *
+ * Each conversion is compared to a 128-bit reference for edge values and for
+ * pseudorandom values across the full 64-bit range.  The conversions are
+ * exact and so the error bound is zero.  The round trip from ticks to an OSC
+ * time tag and back may lose at most one tick because both conversions round
+ * down.  The slave clock is not updated and so is equal to the timer.
+ */
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include <inttypes.h> // PRIu64
+#include <stdbool.h> // bool, true, false
+#include <stdint.h> // uint64_t
+#include <stdio.h> // printf
+#include "Synchronisation/Synchronisation.h"
+
+//------------------------------------------------------------------------------
+// Definitions
+
+/**
+ * @brief Number of pseudorandom values tested for each conversion.
+ */
+#define NUMBER_OF_RANDOM_VALUES 10000000
+
+/**
+ * @brief Largest ticks value for which the OSC time tag does not overflow.
+ * The round trip is only tested up to this value.
+ */
+#define MAX_ROUND_TRIP_TICKS ((uint64_t) TIMER_TICKS_PER_SECOND << 32)
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+static bool TestValue(const uint64_t value);
+static uint64_t GetReferenceOscTimeTag(const uint64_t ticks);
+static uint64_t GetReferenceTicks(const uint64_t oscTimeTag);
+static uint64_t GetRandom();
+
+//------------------------------------------------------------------------------
+// Variables
+
+static uint64_t randomState = 0x9E3779B97F4A7C15ull;
+static int numberOfFailures;
+
+//------------------------------------------------------------------------------
+// Functions
+
+/**
+ * @brief Test entry point.
+ * @return 0 if all tests passed.
+ */
+int main(void) {
+    SynchronisationInitialise();
+
+    // Edge values
+    int numberOfValues = 0;
+    int shift;
+    for (shift = 0; shift < 64; shift++) {
+        const uint64_t powerOfTwo = 1ull << shift;
+        TestValue(powerOfTwo - 1);
+        TestValue(powerOfTwo);
+        TestValue(powerOfTwo + 1);
+        TestValue(-powerOfTwo);
+        numberOfValues += 4;
+    }
+    uint64_t multiple;
+    for (multiple = 0; multiple < 1000; multiple++) {
+        const uint64_t ticks = multiple * TIMER_TICKS_PER_SECOND;
+        TestValue(ticks - 1);
+        TestValue(ticks);
+        TestValue(ticks + 1);
+        TestValue(MAX_ROUND_TRIP_TICKS - ticks);
+        TestValue(MAX_ROUND_TRIP_TICKS - ticks - 1);
+        TestValue(multiple << 32);
+        numberOfValues += 6;
+    }
+    TestValue(UINT64_MAX);
+    numberOfValues++;
+
+    // Pseudorandom values with random magnitude so that all ranges are tested
+    int index;
+    for (index = 0; index < NUMBER_OF_RANDOM_VALUES; index++) {
+        const uint64_t value = GetRandom();
+        TestValue(value >> (GetRandom() % 64));
+        numberOfValues++;
+    }
+
+    printf("%d values, %d failures\n", numberOfValues, numberOfFailures);
+    return numberOfFailures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Tests each conversion for a value used as both a ticks value and an
+ * OSC time tag value.  A message is printed for each failure.
+ * @param value Value.
+ * @return true if all conversions are exact.
+ */
+static bool TestValue(const uint64_t value) {
+    bool pass = true;
+
+    // Ticks to OSC time tag
+    const Ticks64 ticks64 = {.value = value};
+    const uint64_t oscTimeTag = SynchronisationTicksToOscTimeTag(ticks64).value;
+    if (oscTimeTag != GetReferenceOscTimeTag(value)) {
+        printf("FAIL ticks %" PRIu64 " to OSC time tag: %" PRIu64 ", expected %" PRIu64 "\n", value, oscTimeTag, GetReferenceOscTimeTag(value));
+        pass = false;
+    }
+
+    // OSC time tag to ticks
+    const OscTimeTag valueAsOscTimeTag = {.value = value};
+    const uint64_t ticks = SynchronisationOscTimeTagToTicks(valueAsOscTimeTag).value;
+    if (ticks != GetReferenceTicks(value)) {
+        printf("FAIL OSC time tag %" PRIu64 " to ticks: %" PRIu64 ", expected %" PRIu64 "\n", value, ticks, GetReferenceTicks(value));
+        pass = false;
+    }
+
+    // Round trip
+    if (value < MAX_ROUND_TRIP_TICKS) {
+        const OscTimeTag roundTripOscTimeTag = {.value = oscTimeTag};
+        const uint64_t roundTripTicks = SynchronisationOscTimeTagToTicks(roundTripOscTimeTag).value;
+        if ((value - roundTripTicks) > 1) {
+            printf("FAIL round trip of ticks %" PRIu64 ": %" PRIu64 "\n", value, roundTripTicks);
+            pass = false;
+        }
+    }
+    if (pass == false) {
+        numberOfFailures++;
+    }
+    return pass;
+}
+
+/**
+ * @brief Returns floor(ticks * 2^32 / TIMER_TICKS_PER_SECOND) modulo 2^64
+ * calculated with 128-bit arithmetic.
+ * @param ticks Ticks.
+ * @return OSC time tag value.
+ */
+static uint64_t GetReferenceOscTimeTag(const uint64_t ticks) {
+    return (uint64_t) (((unsigned __int128) ticks << 32) / TIMER_TICKS_PER_SECOND);
+}
+
+/**
+ * @brief Returns floor(oscTimeTag * TIMER_TICKS_PER_SECOND / 2^32) modulo 2^64
+ * calculated with 128-bit arithmetic.
+ * @param oscTimeTag OSC time tag value.
+ * @return Ticks.
+ */
+static uint64_t GetReferenceTicks(const uint64_t oscTimeTag) {
+    return (uint64_t) (((unsigned __int128) oscTimeTag * TIMER_TICKS_PER_SECOND) >> 32);
+}
+
+/**
+ * @brief Returns the next value of a xorshift64* pseudorandom sequence.  A
+ * fixed seed is used so that the test is deterministic.
+ * @return Pseudorandom value.
+ */
+static uint64_t GetRandom() {
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 0x2545F4914F6CDD1Dull;
+}
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,28 @@
+/**
+ * @file SynchronisationUnfiltered.c
+ * @author Seb Madgwick
+ * @brief Synchronisation module built with the minimum delay filter disabled.
+ * Each function is renamed with the Unfiltered prefix so that this module may
+ * be linked together with the unmodified module.
+ */
+
+//------------------------------------------------------------------------------
+// Definitions
+
+#define FILTER_DISABLED
+
+#define SynchronisationInitialise UnfilteredSynchronisationInitialise
+#define SynchronisationUpdate UnfilteredSynchronisationUpdate
+#define SynchronisationTicksToOscTimeTag UnfilteredSynchronisationTicksToOscTimeTag
+#define SynchronisationTicksToOscTimeTagAsObserved UnfilteredSynchronisationTicksToOscTimeTagAsObserved
+#define SynchronisationOscTimeTagToTicks UnfilteredSynchronisationOscTimeTagToTicks
+#define SynchronisationGetFrequencyAdjustment UnfilteredSynchronisationGetFrequencyAdjustment
+#define SynchronisationGetNumberOfSteps UnfilteredSynchronisationGetNumberOfSteps
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Synchronisation/Synchronisation.c"
+
+//------------------------------------------------------------------------------
+// End of file
@@ -0,0 +1,31 @@
+/**
+ * @file SynchronisationUnfiltered.h
+ * @author Seb Madgwick
+ * @brief Synchronisation module built with the minimum delay filter disabled
+ * so that the host simulation may compare the servo with and without the
+ * filter.
+ */
+
+#ifndef SYNCHRONISATION_UNFILTERED_H
+#define SYNCHRONISATION_UNFILTERED_H
+
+//------------------------------------------------------------------------------
+// Includes
+
+#include "Synchronisation/Synchronisation.h"
+
+//------------------------------------------------------------------------------
+// Function prototypes
+
+void UnfilteredSynchronisationInitialise();
+void UnfilteredSynchronisationUpdate(const OscTimeTag oscTimeTag, const Ticks64 timeOfReception);
+OscTimeTag UnfilteredSynchronisationTicksToOscTimeTag(const Ticks64 ticks64);
+OscTimeTag UnfilteredSynchronisationTicksToOscTimeTagAsObserved(const Ticks64 ticks64);
+Ticks64 UnfilteredSynchronisationOscTimeTagToTicks(const OscTimeTag oscTimeTag);
+int32_t UnfilteredSynchronisationGetFrequencyAdjustment();
+uint32_t UnfilteredSynchronisationGetNumberOfSteps();
+
+#endif
+
+//------------------------------------------------------------------------------
+// End of file
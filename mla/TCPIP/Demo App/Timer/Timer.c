@@ -6,12 +6,16 @@
  * Provides measurements of time in processor ticks where one tick = 12.5 ns for
  * SYSCLK = 80 MHz.  Ticks32 overflows every 53.687 seconds.  Ticks64 overflows
  * every 7331.868 years.
+ *
+ * This is the single timebase of the firmware.  The TCP/IP stack Tick module
+ * functions are views onto the same 64-bit value so that all timestamps are
+ * obtained from one clock.
  */
 
 //------------------------------------------------------------------------------
 // Includes
 
-#include <stdint.h> // UINT32_MAX
+#include <stdbool.h> // bool
 #include "Timer.h"
 #include <xc.h>
 
@@ -21,12 +25,13 @@
 #define T5_IFSXCLR IFS0CLR
 #define T5_IECXSET IEC0SET
 #define T5_IECXCLR IEC0CLR
+#define T5_IFSX IFS0
 #define T5_INT_BIT (1 << 20)
 
 //------------------------------------------------------------------------------
 // Variable declarations
 
-static volatile Ticks64 timerOverflowCounter;
+static volatile uint32_t timerOverflowCounter; // most-significant dword of 64-bit timer value
 
 //------------------------------------------------------------------------------
 // Functions
@@ -37,6 +42,7 @@ static volatile Ticks64 timerOverflowCounter;
  */
 void TimerInitialise() {
     T4CONbits.T32 = 1;
+    PR4 = 0xFFFFFFFF; // period of 2^32 ticks
     T4CONbits.ON = 1; // start timer
     IPC5bits.T5IP = 7; // set interrupt priority
     T5_IFSXCLR = T5_INT_BIT; // clear interrupt flag
@@ -55,17 +61,27 @@ Ticks32 TimerGetTicks32() {
 
 /**
  * @brief Gets 64-bit timer value.
+ *
+ * This function may be called from any interrupt priority level, or with
+ * interrupts disabled, and does not block.  The read is repeated only if the
+ * overflow interrupt occurs during the read, which can happen at most once
+ * per overflow period.  An overflow that has occurred but has not yet been
+ * serviced, because the caller is at the same or higher priority than the
+ * overflow interrupt, is accounted for using the interrupt flag.
+ *
  * @return 64-bit timer value.
  */
 Ticks64 TimerGetTicks64() {
-    Ticks64 sampledTimerOverflowCounter;
     Ticks64 ticks64;
+    bool isOverflowPending;
     do {
-        sampledTimerOverflowCounter = timerOverflowCounter;
-        ticks64.dword1 = 0;
+        ticks64.dword1 = timerOverflowCounter;
         ticks64.dword0 = TMR4; // read 32-bit timer value
-    } while (sampledTimerOverflowCounter.dword0 != timerOverflowCounter.dword0); // avoid seconds overflow hazard
-    ticks64.value += sampledTimerOverflowCounter.value;
+        isOverflowPending = (T5_IFSX & T5_INT_BIT) != 0;
+    } while (ticks64.dword1 != timerOverflowCounter); // overflow interrupt occurred during read
+    if (isOverflowPending && (ticks64.dword0 < 0x80000000)) {
+        ticks64.dword1++; // timer value read after unserviced overflow
+    }
     return ticks64;
 }
 
@@ -85,10 +101,11 @@ void TimerDelay(uint32_t milliseconds) {
 // Functions - Interrupts
 
 /**
- * @brief Timer overflow interrupt to increment overflow counter.
+ * @brief Timer overflow interrupt to increment overflow counter.  Each
+ * overflow represents 2^32 ticks.
  */
 void __attribute__((interrupt(), vector(_TIMER_5_VECTOR))) Timer5Interrupt() {
-    timerOverflowCounter.value += (uint64_t) UINT32_MAX;
+    timerOverflowCounter++;
     T5_IFSXCLR = T5_INT_BIT; // clear interrupt flag
 }
 